@@ -0,0 +1,30 @@
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = xmljson
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+        conversiontask.cpp \
+        main.cpp
+
+HEADERS += \
+        conversiontask.h
+
+# Peak memory of the --stats summary
+win32: LIBS += -lpsapi
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+# Include library files
+include(../qt-xml-json-library/qt-xml-json-library.pri)
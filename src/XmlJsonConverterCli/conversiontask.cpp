@@ -0,0 +1,394 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "conversiontask.h"
+
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QTextStream>
+
+namespace LTDev {
+
+namespace {
+
+/**
+ * @brief Write only device forwarding to another device and counting the
+ * bytes written, for outputs whose position isn't available, like pipes
+ */
+class CountingDevice : public QIODevice
+{
+public:
+    CountingDevice(QIODevice *target) : m_target(target), m_count(0)
+    {
+        open(QIODevice::WriteOnly);
+    }
+
+    bool isSequential() const override
+    {
+        return true;
+    }
+
+    qint64 count() const
+    {
+        return m_count;
+    }
+
+protected:
+    qint64 readData(char *, qint64) override
+    {
+        return -1;
+    }
+
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        qint64 written = m_target->write(data, len);
+        if(written > 0){
+            m_count += written;
+        }
+        return written;
+    }
+
+private:
+    QIODevice *m_target;
+    qint64 m_count;
+};
+
+/**
+ * @brief Read only device forwarding the reads of another device, counting
+ * the bytes read and keeping the first ones, for inputs which can't be read
+ * twice, like pipes
+ */
+class RecordingDevice : public QIODevice
+{
+public:
+    RecordingDevice(QIODevice *source, int prefixSize) : m_source(source), m_prefixSize(prefixSize), m_count(0)
+    {
+        open(QIODevice::ReadOnly);
+    }
+
+    bool isSequential() const override
+    {
+        return true;
+    }
+
+    qint64 count() const
+    {
+        return m_count;
+    }
+
+    QByteArray prefix() const
+    {
+        return m_prefix;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        qint64 read = m_source->read(data, maxSize);
+
+        if(read > 0){
+            if(m_prefix.size() < m_prefixSize){
+                m_prefix.append(data, int(qMin<qint64>(read, m_prefixSize - m_prefix.size())));
+            }
+            m_count += read;
+        }
+
+        return read;
+    }
+
+    qint64 writeData(const char *, qint64) override
+    {
+        return -1;
+    }
+
+private:
+    QIODevice *m_source;
+    int m_prefixSize;
+    qint64 m_count;
+    QByteArray m_prefix;
+};
+
+/**
+ * @brief Returns the line of the input prefix, or an empty string if the
+ * prefix doesn't contain it whole
+ */
+QByteArray prefixLine(const QByteArray &prefix, qint64 line)
+{
+    int start = 0;
+
+    for(qint64 i=1; i<line; i++){
+        start = prefix.indexOf('\n', start) + 1;
+        if(start == 0){
+            return QByteArray();
+        }
+    }
+
+    int end = prefix.indexOf('\n', start);
+    if(end < 0){
+        return QByteArray();
+    }
+
+    return prefix.mid(start, end - start);
+}
+
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param inputPath: the file to convert, "-" for stdin
+ * @param outputPath: the converted file, "-" for stdout
+ * @param settings: the conversion settings
+ */
+ConversionTask::ConversionTask(const QString &inputPath, const QString &outputPath, const Settings &settings)
+    : m_inputPath(inputPath), m_outputPath(outputPath), m_settings(settings),
+      m_errorLine(0), m_inputBytes(0), m_outputBytes(0), m_elapsedUs(0)
+{
+    // Owned by the caller, which waits for it and reads the results
+    setAutoDelete(false);
+}
+
+
+/**
+ * Converts the input into the output. Files are written through QSaveFile,
+ * so a failed conversion never leaves a truncated output behind.
+ */
+void ConversionTask::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile inputFile;
+    QIODevice *input = &inputFile;
+
+    // Pipes are read as they are consumed: only their first bytes are kept,
+    // to show the line of a parse error
+    QFile in;
+    QScopedPointer<RecordingDevice> recorder;
+
+    if(m_inputPath == "-"){
+        in.open(stdin, QIODevice::ReadOnly);
+        recorder.reset(new RecordingDevice(&in, 64 * 1024));
+        input = recorder.data();
+    } else {
+        inputFile.setFileName(m_inputPath);
+        if(!inputFile.open(QIODevice::ReadOnly)){
+            m_error = "Error while loading file: " + inputFile.errorString();
+        }
+        m_inputBytes = inputFile.size();
+    }
+
+    if(m_error.isEmpty()){
+        if(m_outputPath == "-"){
+            QFile out;
+            out.open(stdout, QIODevice::WriteOnly);
+            CountingDevice counter(&out);
+
+            convert(input, &counter);
+            m_outputBytes = counter.count();
+        } else {
+            QSaveFile out(m_outputPath);
+            QSaveFile index(JsonIndex::indexPath(m_outputPath));
+            bool indexed = m_settings.index && m_settings.direction == ToJson;
+
+            if(!out.open(QIODevice::WriteOnly) || (indexed && !index.open(QIODevice::WriteOnly))){
+                m_error = "Error while writing file: " + (out.isOpen() ? index.errorString() : out.errorString());
+            } else if(convert(input, &out, indexed ? &index : nullptr)){
+                m_outputBytes = out.pos();
+
+                if(!out.commit()){
+                    m_error = "Error while writing file: " + out.errorString();
+                } else if(indexed && !index.commit()){
+                    m_error = "Error while writing file: " + index.errorString();
+                }
+            }
+        }
+    }
+
+    if(recorder){
+        m_inputBytes = recorder->count();
+
+        QByteArray line = m_errorLine > 0 ? prefixLine(recorder->prefix(), m_errorLine) : QByteArray();
+        if(!line.isEmpty()){
+            m_error += "\n    " + QString::fromUtf8(line);
+        }
+    }
+
+    m_elapsedUs = timer.nsecsElapsed() / 1000;
+    m_done.release();
+}
+
+
+/**
+ * Waits until the task has run
+ */
+void ConversionTask::wait()
+{
+    m_done.acquire();
+}
+
+
+/**
+ * Returns the input path, "-" for stdin
+ *
+ * @return QString
+ */
+QString ConversionTask::inputPath() const
+{
+    return m_inputPath;
+}
+
+
+/**
+ * Returns true if the conversion failed
+ *
+ * @return bool
+ */
+bool ConversionTask::hasError() const
+{
+    return !m_error.isEmpty();
+}
+
+
+/**
+ * Returns the error description
+ *
+ * @return QString
+ */
+QString ConversionTask::errorString() const
+{
+    return m_error;
+}
+
+
+/**
+ * Returns the size of the input, in bytes
+ *
+ * @return qint64
+ */
+qint64 ConversionTask::inputBytes() const
+{
+    return m_inputBytes;
+}
+
+
+/**
+ * Returns the size of the output, in bytes
+ *
+ * @return qint64
+ */
+qint64 ConversionTask::outputBytes() const
+{
+    return m_outputBytes;
+}
+
+
+/**
+ * Returns the conversion time, in microseconds
+ *
+ * @return qint64
+ */
+qint64 ConversionTask::elapsedUs() const
+{
+    return m_elapsedUs;
+}
+
+
+/**
+ * Converts the input device into the output device. The json output is
+ * written while walking the parsed document, without building the json
+ * object in memory; in pipelined mode the document isn't built either.
+ * The json input must be parsed whole by QJsonDocument: files are mapped
+ * in memory rather than read, and the xml output is written to the device
+ * as it is serialized, without building it as a string first. Returns
+ * false on error, setting the error description.
+ *
+ * @param input: the device to read from
+ * @param output: the device to write to
+ * @param index: the device to write the json index to, or nullptr
+ *
+ * @return bool
+ */
+bool ConversionTask::convert(QIODevice *input, QIODevice *output, QIODevice *index)
+{
+    if(m_settings.direction == ToJson && m_settings.pipelined){
+        ConversionError error;
+
+        if(!XmlJsonConverter::writeJsonPipelined(input, output, m_settings.options, m_settings.format, index, &error)){
+            m_error = QString("%1 (line %2, column %3)").arg(error.message).arg(error.line).arg(error.column);
+            m_errorLine = error.line;
+            return false;
+        }
+    } else if(m_settings.direction == ToJson){
+        ConversionError error;
+
+        QDomDocument xmlDoc = XmlToJson::parse(input, m_settings.options, &error);
+        if(error.hasError()){
+            m_error = QString("%1 (line %2, column %3)").arg(error.message).arg(error.line).arg(error.column);
+            m_errorLine = error.line;
+            return false;
+        }
+
+        if(!XmlJsonConverter::writeJson(xmlDoc, output, m_settings.format, index, &error)){
+            m_error = error.message;
+            return false;
+        }
+    } else {
+        QFile *file = qobject_cast<QFile *>(input);
+        uchar *mapped = file && file->size() > 0 ? file->map(0, file->size()) : nullptr;
+
+        QByteArray data = mapped ? QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), int(file->size()))
+                                 : input->readAll();
+
+        QJsonParseError error;
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &error);
+
+        // The parsed document doesn't reference the data
+        data.clear();
+        if(mapped){
+            file->unmap(mapped);
+        }
+
+        if(error.error != QJsonParseError::NoError){
+            m_error = QString("%1 (offset %2)").arg(error.errorString()).arg(error.offset);
+            return false;
+        }
+
+        QTextStream stream(output);
+        stream.setCodec("UTF-8");
+
+        XmlJsonConverter::toXml(jsonDoc.object()).save(stream, m_settings.format == QJsonDocument::Compact ? -1 : 1);
+        stream.flush();
+
+        if(stream.status() != QTextStream::Ok){
+            m_error = "Error while writing xml: " + output->errorString();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
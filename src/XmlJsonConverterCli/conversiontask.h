@@ -0,0 +1,125 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERSIONTASK_H
+#define CONVERSIONTASK_H
+
+#include <QRunnable>
+#include <QSemaphore>
+
+#include "xmljsonconverter.h"
+
+
+namespace LTDev {
+
+class ConversionTask : public QRunnable
+{
+public:
+    /**
+     * @brief Conversion direction
+     */
+    enum Direction {
+        ToJson,
+        ToXml
+    };
+
+    /**
+     * @brief Conversion settings shared by the tasks
+     */
+    struct Settings {
+        Direction direction;
+        QJsonDocument::JsonFormat format;
+        ConversionOptions options;
+        bool index;
+        bool pipelined;
+    };
+
+    /**
+     * @brief Constructor
+     */
+    ConversionTask(const QString &inputPath, const QString &outputPath, const Settings &settings);
+
+    /**
+     * @brief Converts the input into the output
+     */
+    void run() override;
+
+    /**
+     * @brief Waits until the task has run
+     */
+    void wait();
+
+    /**
+     * @brief Returns the input path, "-" for stdin
+     */
+    QString inputPath() const;
+
+    /**
+     * @brief Returns true if the conversion failed
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Returns the error description
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Returns the size of the input, in bytes
+     */
+    qint64 inputBytes() const;
+
+    /**
+     * @brief Returns the size of the output, in bytes
+     */
+    qint64 outputBytes() const;
+
+    /**
+     * @brief Returns the conversion time, in microseconds
+     */
+    qint64 elapsedUs() const;
+
+private:
+    /**
+     * @brief Converts the input device into the output device, writing the index if a device is passed.
+     * Returns false on error.
+     */
+    bool convert(QIODevice *input, QIODevice *output, QIODevice *index = nullptr);
+
+    QString m_inputPath;
+    QString m_outputPath;
+    Settings m_settings;
+
+    QString m_error;
+    qint64 m_errorLine;
+    qint64 m_inputBytes;
+    qint64 m_outputBytes;
+    qint64 m_elapsedUs;
+
+    QSemaphore m_done;
+};
+
+}
+
+#endif // CONVERSIONTASK_H
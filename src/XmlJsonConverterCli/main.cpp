@@ -0,0 +1,284 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include "conversiontask.h"
+#include "xmljsonconverter.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+/**
+ * @brief Returns the peak resident memory of the process, in bytes, or -1 if not available
+ *
+ * @return qint64
+ */
+qint64 peakMemory(){
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))){
+        return qint64(counters.PeakWorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0){
+        return -1;
+    }
+#if defined(Q_OS_MACOS)
+    return qint64(usage.ru_maxrss);
+#else
+    return qint64(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Expands the wildcards of the file names passed, for the shells which don't.
+ * Arguments without wildcards, or naming an existing file, are kept as they are.
+ *
+ * @param args: the file names and patterns
+ *
+ * @return QStringList
+ */
+QStringList expandInputs(const QStringList &args){
+    QStringList inputs;
+    QRegularExpression wildcards("[*?\\[]");
+
+    foreach (const QString &arg, args) {
+        if(arg == "-" || QFileInfo::exists(arg) || !arg.contains(wildcards)){
+            inputs.append(arg);
+            continue;
+        }
+
+        QFileInfo info(arg);
+        QDir dir = info.dir();
+        QStringList names = dir.entryList(QStringList(info.fileName()), QDir::Files, QDir::Name);
+
+        if(names.isEmpty()){
+            qWarning().noquote() << "No file matches" << arg;
+        }
+
+        foreach (const QString &name, names) {
+            inputs.append(dir.filePath(name));
+        }
+    }
+
+    return inputs;
+}
+
+/**
+ * @brief Returns the row of the --stats table: the first column left aligned, the others right aligned
+ *
+ * @param columns: the column values
+ *
+ * @return QString
+ */
+QString statsRow(const QStringList &columns){
+    QString row = columns.value(0).leftJustified(40);
+
+    for(int i=1; i<columns.size(); i++){
+        row += columns.at(i).rightJustified(14);
+    }
+
+    return row + "\n";
+}
+
+/**
+ * @brief Returns the throughput in MB/s
+ *
+ * @param bytes: the bytes processed
+ * @param us: the elapsed time, in microseconds
+ *
+ * @return QString
+ */
+QString throughput(qint64 bytes, qint64 us){
+    return us > 0 ? QString::number(bytes / double(us), 'f', 2) : "-";
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("xmljson");
+    QCoreApplication::setApplicationVersion(LTDev::XmlJsonConverter::version());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Converts XML files into JSON and JSON files into XML.\n"
+                                     "The direction is chosen by the input suffix, unless forced.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {{"o", "output"}, "Write the output of the single input into file, \"-\" for stdout.", "file"},
+        {{"d", "output-dir"}, "Write the outputs into dir, named after the inputs. Required by several inputs.", "dir"},
+        {"to-json", "Convert the inputs into json."},
+        {"to-xml", "Convert the inputs into xml."},
+        {"compact", "Write compact output."},
+        {"index", "Write the index of the elements of each json output file, into <output>.idx."},
+        {"pipelined", "Read, convert and write each xml file on separate threads, without building the document."},
+        {{"j", "jobs"}, "Convert up to n files in parallel.", "n", "1"},
+        {"stats", "Print throughput, peak memory and per-file timings on stderr."}
+    });
+    parser.addPositionalArgument("inputs", "Files or file name patterns to convert, \"-\" or none for stdin.", "[inputs...]");
+
+    parser.process(a);
+
+    QTextStream err(stderr);
+
+    QStringList inputs = expandInputs(parser.positionalArguments());
+    if(inputs.isEmpty()){
+        inputs.append("-");
+    }
+
+    if(parser.isSet("output") && (inputs.size() > 1 || parser.isSet("output-dir"))){
+        err << "--output requires a single input and no --output-dir\n";
+        return 2;
+    }
+
+    // Each output is written as it is converted: several outputs can't share stdout
+    if(inputs.size() > 1 && !parser.isSet("output-dir")){
+        err << "Several inputs require --output-dir\n";
+        return 2;
+    }
+
+    if(parser.isSet("index") && !parser.isSet("output-dir") && (!parser.isSet("output") || parser.value("output") == "-")){
+        err << "--index requires output files\n";
+        return 2;
+    }
+
+    if(parser.isSet("to-json") && parser.isSet("to-xml")){
+        err << "--to-json and --to-xml are exclusive\n";
+        return 2;
+    }
+
+    QString outputDir = parser.value("output-dir");
+    if(!outputDir.isEmpty() && !QDir().mkpath(outputDir)){
+        err << "Error while creating directory: " << outputDir << "\n";
+        return 1;
+    }
+
+    LTDev::ConversionTask::Settings settings;
+    settings.format = parser.isSet("compact") ? QJsonDocument::Compact : QJsonDocument::Indented;
+    settings.index = parser.isSet("index");
+    settings.pipelined = parser.isSet("pipelined");
+
+    // Create the tasks, writing into the output files or, for a single input, on stdout
+    QList<LTDev::ConversionTask *> tasks;
+
+    foreach (const QString &input, inputs) {
+        if(parser.isSet("to-xml")){
+            settings.direction = LTDev::ConversionTask::ToXml;
+        } else if(parser.isSet("to-json") || input == "-"){
+            settings.direction = LTDev::ConversionTask::ToJson;
+        } else {
+            bool isJson = QFileInfo(input).suffix().compare("json", Qt::CaseInsensitive) == 0;
+            settings.direction = isJson ? LTDev::ConversionTask::ToXml : LTDev::ConversionTask::ToJson;
+        }
+
+        QString output;
+        if(parser.isSet("output")){
+            output = parser.value("output");
+        } else if(!outputDir.isEmpty()){
+            QString baseName = input == "-" ? QString("stdin") : QFileInfo(input).completeBaseName();
+            QString suffix = settings.direction == LTDev::ConversionTask::ToJson ? ".json" : ".xml";
+            output = QDir(outputDir).filePath(baseName + suffix);
+        } else {
+            output = "-";
+        }
+
+        tasks.append(new LTDev::ConversionTask(input, output, settings));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, parser.value("jobs").toInt()));
+
+    foreach (LTDev::ConversionTask *task, tasks) {
+        pool.start(task);
+    }
+
+    int failures = 0;
+    qint64 inputBytes = 0, outputBytes = 0;
+
+    if(parser.isSet("stats")){
+        err << statsRow({"file", "input", "output", "time (ms)", "MB/s"});
+        err.flush();
+    }
+
+    foreach (LTDev::ConversionTask *task, tasks) {
+        task->wait();
+
+        if(task->hasError()){
+            failures++;
+            err << task->inputPath() << ": " << task->errorString() << "\n";
+        }
+
+        inputBytes += task->inputBytes();
+        outputBytes += task->outputBytes();
+
+        if(parser.isSet("stats")){
+            err << statsRow({task->inputPath(), QString::number(task->inputBytes()), QString::number(task->outputBytes()),
+                             QString::number(task->elapsedUs() / 1000.0, 'f', 2),
+                             throughput(task->inputBytes(), task->elapsedUs())});
+        }
+
+        // Report each file as soon as it is converted
+        err.flush();
+    }
+
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+
+    if(parser.isSet("stats")){
+        qint64 peak = peakMemory();
+
+        err << "\n"
+            << "files:       " << tasks.size() << " (" << failures << " failed)\n"
+            << "input:       " << inputBytes << " bytes\n"
+            << "output:      " << outputBytes << " bytes\n"
+            << "wall time:   " << QString::number(elapsedUs / 1000.0, 'f', 2) << " ms\n"
+            << "throughput:  " << throughput(inputBytes, elapsedUs) << " MB/s\n"
+            << "peak memory: " << (peak < 0 ? QString("-") : QString::number(peak / (1024.0 * 1024.0), 'f', 1) + " MB") << "\n";
+        err.flush();
+    }
+
+    qDeleteAll(tasks);
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,185 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocalSocket>
+
+#include <limits>
+
+#include "daemonprotocol.h"
+
+/**
+ * @brief Sends the request to the daemon and waits for its response.
+ * Returns true if the response has been received, false otherwise.
+ *
+ * @param serverName: the name of the daemon local socket
+ * @param request: the request to send
+ * @param response: the response received
+ * @param timeout: the maximum time to wait, in milliseconds
+ * @param maxResponseSize: the maximum size of the response frame, in bytes
+ *
+ * @return bool
+ */
+bool send(const QString &serverName, const LTDev::DaemonRequest &request, LTDev::DaemonResponse &response,
+          int timeout, quint32 maxResponseSize){
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+
+    if(!socket.waitForConnected(timeout)){
+        qCritical().noquote() << "Error while connecting to the daemon:" << socket.errorString();
+        return false;
+    }
+
+    socket.write(LTDev::DaemonProtocol::frame(request));
+
+    QByteArray buffer;
+    QByteArray payload;
+    bool oversized = false;
+
+    while(!LTDev::DaemonProtocol::takeFrame(buffer, payload, maxResponseSize, &oversized)){
+        if(oversized){
+            qCritical() << "Response exceeds the maximum size: pass an output file, or raise --max-response-size";
+            return false;
+        }
+
+        if(!socket.waitForReadyRead(timeout)){
+            qCritical().noquote() << "Error while waiting for the response:" << socket.errorString();
+            return false;
+        }
+
+        buffer += socket.readAll();
+    }
+
+    if(!LTDev::DaemonProtocol::response(payload, response)){
+        qCritical() << "Malformed response";
+        return false;
+    }
+
+    return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("XmlJsonConverterClient");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Converts XML and JSON files through the conversion daemon.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"name", "Name of the daemon local socket.", "name", LTDev::DaemonProtocol::defaultServerName()},
+        {"to-xml", "Convert json into xml."},
+        {"compact", "Write compact output."},
+        {"inline", "Send the input content instead of its path."},
+        {"timeout", "Maximum time to wait for the daemon, in seconds.", "seconds", "60"},
+        {"max-response-size", "Maximum size of the response, in MB.", "mb", "1024"},
+        {"max-input-bytes", "Reject inputs larger than the bytes passed.", "bytes"},
+        {"max-elements", "Reject documents with more elements.", "count"},
+        {"max-depth", "Reject documents with a deeper element nesting.", "depth"},
+        {"max-attributes", "Reject elements with more attributes.", "count"},
+        {"max-text-length", "Reject texts with more characters.", "length"},
+        {"max-output-bytes", "Reject documents whose estimated json exceeds the bytes passed.", "bytes"}
+    });
+    parser.addPositionalArgument("input", "The file to convert.");
+    parser.addPositionalArgument("output", "The converted file, stdout if omitted.", "[output]");
+
+    parser.process(a);
+
+    QStringList args = parser.positionalArguments();
+    if(args.isEmpty()){
+        parser.showHelp(1);
+    }
+
+    LTDev::DaemonRequest request;
+    request.direction = parser.isSet("to-xml") ? LTDev::DaemonRequest::ToXml : LTDev::DaemonRequest::ToJson;
+    request.options.insert("compact", parser.isSet("compact"));
+
+    // Limits checked by the daemon, see ConversionLimits
+    typedef QPair<QString, QString> Limit;
+    const QList<Limit> limits = {
+        {"max-input-bytes", "maxInputBytes"},
+        {"max-elements", "maxElements"},
+        {"max-depth", "maxDepth"},
+        {"max-attributes", "maxAttributes"},
+        {"max-text-length", "maxTextLength"},
+        {"max-output-bytes", "maxOutputBytes"}
+    };
+
+    foreach (const Limit &limit, limits) {
+        if(!parser.isSet(limit.first)){
+            continue;
+        }
+
+        bool ok = false;
+        qint64 value = parser.value(limit.first).toLongLong(&ok);
+        if(!ok || value < 0){
+            qCritical().noquote() << QString("Invalid value of --%1:").arg(limit.first) << parser.value(limit.first);
+            return 1;
+        }
+
+        request.options.insert(limit.second, value);
+    }
+
+    // The daemon resolves the paths from its own working directory
+    if(parser.isSet("inline")){
+        QFile f(args.at(0));
+        if(!f.open(QIODevice::ReadOnly)){
+            qCritical().noquote() << "Error while loading file:" << args.at(0);
+            return 1;
+        }
+        request.data = f.readAll();
+    } else {
+        request.inputPath = QFileInfo(args.at(0)).absoluteFilePath();
+    }
+
+    if(args.size() > 1){
+        request.outputPath = QFileInfo(args.at(1)).absoluteFilePath();
+    }
+
+    quint64 maxResponseSize = parser.value("max-response-size").toULongLong() * 1024 * 1024;
+    if(maxResponseSize == 0 || maxResponseSize > std::numeric_limits<quint32>::max()){
+        maxResponseSize = std::numeric_limits<quint32>::max();
+    }
+
+    LTDev::DaemonResponse response;
+    if(!send(parser.value("name"), request, response, parser.value("timeout").toInt() * 1000, quint32(maxResponseSize))){
+        return 1;
+    }
+
+    if(response.code != 0){
+        qCritical().noquote() << response.message;
+        return 1;
+    }
+
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+    out.write(response.output);
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+QT -= gui
+QT += network
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+        conversionjob.cpp \
+        conversionserver.cpp \
+        main.cpp \
+        memorycache.cpp
+
+HEADERS += \
+        conversionjob.h \
+        conversionserver.h \
+        memorycache.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+# Include library files
+include(../qt-xml-json-library/qt-xml-json-library.pri)
+
+# Include daemon protocol files
+include(daemonprotocol.pri)
+
+DISTFILES += \
+    benchmark.sh
@@ -0,0 +1,73 @@
+#!/bin/sh
+# Compares the per-file latency of a cold conversion process with the latency
+# of the same conversion requested to a running daemon: without caches, so
+# that every request is converted by the warm process, and with the default
+# in-memory cache, so that the repeated requests are cache hits.
+#
+# Usage: benchmark.sh <daemon binary> <client binary> [iterations] [files...]
+# The samples of XmlJsonConverterSample are converted if no file is passed.
+
+DAEMON=${1:?daemon binary}
+CLIENT=${2:?client binary}
+ITERATIONS=${3:-20}
+if [ $# -ge 3 ]; then shift 3; else shift $#; fi
+
+if [ $# -eq 0 ]; then
+    set -- "$(dirname "$0")"/../XmlJsonConverterSample/samples/*.xml "$(dirname "$0")"/../XmlJsonConverterSample/samples/*.svg
+fi
+
+NAME=xmljsonconverter-benchmark-$$
+CACHED_NAME=xmljsonconverter-benchmark-cached-$$
+
+# Milliseconds elapsed running the command ITERATIONS times
+elapsed() {
+    start=$(date +%s%N)
+    i=0
+    while [ $i -lt "$ITERATIONS" ]; do
+        "$@" > /dev/null || return 1
+        i=$((i + 1))
+    done
+    end=$(date +%s%N)
+    echo $(( (end - start) / 1000000 ))
+}
+
+# Starts a daemon listening on the name passed, with the options passed, and
+# waits for it to listen
+start() {
+    name=$1
+    shift
+    "$DAEMON" --name "$name" "$@" > /dev/null 2>&1 &
+    PIDS="$PIDS $!"
+
+    i=0
+    until "$CLIENT" --name "$name" --timeout 1 "$FIRST" > /dev/null 2>&1; do
+        i=$((i + 1))
+        if [ $i -ge 50 ]; then
+            echo "The daemon did not start" >&2
+            exit 1
+        fi
+        sleep 0.1
+    done
+}
+
+FIRST=$1
+PIDS=
+trap 'kill $PIDS 2>/dev/null' EXIT
+
+# No cache directory, and no in-memory cache: each request is converted
+start "$NAME" --memory-cache-size 0
+start "$CACHED_NAME"
+
+printf "%-40s %12s %12s %8s %12s\n" "file" "cold (ms)" "daemon (ms)" "speedup" "cached (ms)"
+
+for f in "$@"; do
+    cold=$(elapsed "$DAEMON" --once "$f") || exit 1
+    warm=$(elapsed "$CLIENT" --name "$NAME" "$f") || exit 1
+    cached=$(elapsed "$CLIENT" --name "$CACHED_NAME" "$f") || exit 1
+
+    printf "%-40s %12s %12s %8s %12s\n" "$(basename "$f")" \
+        "$(echo "scale=2; $cold / $ITERATIONS" | bc)" \
+        "$(echo "scale=2; $warm / $ITERATIONS" | bc)" \
+        "$(echo "scale=1; $cold / ($warm + 0.001)" | bc)" \
+        "$(echo "scale=2; $cached / $ITERATIONS" | bc)"
+done
@@ -0,0 +1,225 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "conversionjob.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QSaveFile>
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ *
+ * @param connectionId: the connection on which the request was received
+ * @param request: the request to process
+ * @param memoryCache: the in-memory cache of the recent conversions, or nullptr
+ * @param cache: the conversion cache, or nullptr
+ * @param receiver: the object whose onJobFinished slot receives the response frame
+ */
+ConversionJob::ConversionJob(quint64 connectionId, const DaemonRequest &request, MemoryCache *memoryCache, ConversionCache *cache,
+                             QObject *receiver)
+    : m_connectionId(connectionId), m_request(request), m_memoryCache(memoryCache), m_cache(cache), m_receiver(receiver)
+{
+
+}
+
+
+/**
+ * Processes the request in the worker thread, and posts the response frame
+ * to the receiver, which gets it in its own thread. The job isn't a QObject,
+ * so the pool can delete it in the worker thread. The receiver must outlive
+ * the job, as the server does by waiting for its pool when destroyed; the
+ * posted call is dropped if the receiver is destroyed before handling it.
+ */
+void ConversionJob::run()
+{
+    QByteArray frame = DaemonProtocol::frame(process(m_request, m_memoryCache, m_cache));
+
+    QMetaObject::invokeMethod(m_receiver, "onJobFinished", Qt::QueuedConnection,
+                              Q_ARG(quint64, m_connectionId), Q_ARG(QByteArray, frame));
+}
+
+
+/**
+ * Processes the request and returns the response. The input is read from the
+ * request path or taken inline; converted outputs are looked up in the memory
+ * cache first, then in the conversion cache, keyed by the input content and
+ * the options.
+ *
+ * @param request: the request to process
+ * @param memoryCache: the in-memory cache of the recent conversions, or nullptr
+ * @param cache: the conversion cache, or nullptr
+ *
+ * @return DaemonResponse
+ */
+DaemonResponse ConversionJob::process(const DaemonRequest &request, MemoryCache *memoryCache, ConversionCache *cache)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    DaemonResponse response;
+    response.id = request.id;
+
+    QByteArray input = request.data;
+
+    if(!request.inputPath.isEmpty()){
+        QFile f(request.inputPath);
+        qint64 maxInputBytes = options(request).limits.maxInputBytes;
+
+        if(!f.open(QIODevice::ReadOnly)){
+            response.code = ConversionError::FileOpenError;
+            response.message = "Error while loading file: " + request.inputPath;
+        } else if(maxInputBytes > 0 && f.size() > maxInputBytes){
+            response.code = ConversionError::InputTooLarge;
+            response.message = QString("Input exceeds %1 bytes").arg(maxInputBytes);
+        } else {
+            input = f.readAll();
+        }
+    }
+
+    if(response.code == ConversionError::NoError){
+        ConversionCache::Direction direction = request.direction == DaemonRequest::ToJson
+                ? ConversionCache::XmlToJsonDirection : ConversionCache::JsonToXmlDirection;
+
+        // The options are part of the key: the output format changes the stored
+        // output, and the limits may reject an input that other requests accepted.
+        // They are keyed by value, so an absent option and its default share the entries.
+        QByteArray key;
+        if(memoryCache || cache){
+            bool compact = request.options.value("compact").toBool();
+            key = ConversionCache::key(input, direction, options(request).id() + (compact ? "compact=1;" : "compact=0;"));
+        }
+
+        // Warm hits don't access the cache files
+        bool found = memoryCache && memoryCache->find(key, response.output);
+
+        if(!found && cache && cache->find(key, response.output)){
+            found = true;
+
+            if(memoryCache){
+                memoryCache->insert(key, response.output);
+            }
+        }
+
+        if(!found){
+            convert(request, input, response);
+
+            if(response.code == ConversionError::NoError){
+                if(memoryCache){
+                    memoryCache->insert(key, response.output);
+                }
+                if(cache){
+                    cache->insert(key, response.output);
+                }
+            }
+        }
+    }
+
+    // Write the output into the requested file, instead of sending it back
+    if(response.code == ConversionError::NoError && !request.outputPath.isEmpty()){
+        QSaveFile f(request.outputPath);
+
+        if(!f.open(QIODevice::WriteOnly) || f.write(response.output) != response.output.size() || !f.commit()){
+            response.code = ConversionError::FileOpenError;
+            response.message = "Error while writing file: " + request.outputPath;
+        }
+
+        response.output.clear();
+    }
+
+    response.elapsedUs = timer.nsecsElapsed() / 1000;
+
+    return response;
+}
+
+
+/**
+ * Returns the conversion options of the request
+ *
+ * @param request: the request
+ *
+ * @return ConversionOptions
+ */
+ConversionOptions ConversionJob::options(const DaemonRequest &request)
+{
+    const QVariantMap &map = request.options;
+
+    ConversionOptions options;
+    options.limits.maxInputBytes = map.value("maxInputBytes").toLongLong();
+    options.limits.maxElements = map.value("maxElements").toLongLong();
+    options.limits.maxDepth = map.value("maxDepth").toInt();
+    options.limits.maxAttributes = map.value("maxAttributes").toInt();
+    options.limits.maxTextLength = map.value("maxTextLength").toLongLong();
+    options.limits.maxOutputBytes = map.value("maxOutputBytes").toLongLong();
+
+    return options;
+}
+
+
+/**
+ * Converts the input, setting the output or the error of the response
+ *
+ * @param request: the request
+ * @param input: the data to convert
+ * @param response: the response to update
+ */
+void ConversionJob::convert(const DaemonRequest &request, const QByteArray &input, DaemonResponse &response)
+{
+    bool compact = request.options.value("compact").toBool();
+
+    if(request.direction == DaemonRequest::ToJson){
+        ConversionOptions conversionOptions = options(request);
+        ConversionError error;
+
+        QBuffer buffer;
+        buffer.setData(input);
+        buffer.open(QIODevice::ReadOnly);
+
+        QDomDocument xmlDoc = XmlToJson::parse(&buffer, conversionOptions, &error);
+        if(error.hasError()){
+            response.code = error.code;
+            response.message = QString("%1 (line %2, column %3)").arg(error.message).arg(error.line).arg(error.column);
+            return;
+        }
+
+        QJsonObject jsonObj = XmlJsonConverter::toJson(xmlDoc);
+        response.output = QJsonDocument(jsonObj).toJson(compact ? QJsonDocument::Compact : QJsonDocument::Indented);
+    } else {
+        QJsonParseError error;
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(input, &error);
+
+        if(error.error != QJsonParseError::NoError){
+            response.code = ConversionError::ParseError;
+            response.message = QString("%1 (offset %2)").arg(error.errorString()).arg(error.offset);
+            return;
+        }
+
+        QDomDocument xmlDoc = XmlJsonConverter::toXml(jsonDoc.object());
+        response.output = xmlDoc.toByteArray(compact ? -1 : 1);
+    }
+}
+
+}
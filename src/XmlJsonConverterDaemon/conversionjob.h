@@ -0,0 +1,77 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERSIONJOB_H
+#define CONVERSIONJOB_H
+
+#include <QObject>
+#include <QRunnable>
+
+#include "daemonprotocol.h"
+#include "memorycache.h"
+#include "xmljsonconverter.h"
+
+
+namespace LTDev {
+
+class ConversionJob : public QRunnable
+{
+public:
+    /**
+     * @brief Constructor. The response frame is posted to the onJobFinished(quint64, QByteArray) slot of the receiver.
+     */
+    ConversionJob(quint64 connectionId, const DaemonRequest &request, MemoryCache *memoryCache, ConversionCache *cache,
+                  QObject *receiver);
+
+    /**
+     * @brief Processes the request and posts the response frame to the receiver
+     */
+    void run() override;
+
+    /**
+     * @brief Processes the request and returns the response
+     */
+    static DaemonResponse process(const DaemonRequest &request, MemoryCache *memoryCache, ConversionCache *cache);
+
+private:
+    /**
+     * @brief Returns the conversion options of the request
+     */
+    static ConversionOptions options(const DaemonRequest &request);
+
+    /**
+     * @brief Converts the input, setting the output or the error of the response
+     */
+    static void convert(const DaemonRequest &request, const QByteArray &input, DaemonResponse &response);
+
+    quint64 m_connectionId;
+    DaemonRequest m_request;
+    MemoryCache *m_memoryCache;
+    ConversionCache *m_cache;
+    QObject *m_receiver;
+};
+
+}
+
+#endif // CONVERSIONJOB_H
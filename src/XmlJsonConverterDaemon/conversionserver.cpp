@@ -0,0 +1,202 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "conversionserver.h"
+
+#include "conversionjob.h"
+#include "daemonprotocol.h"
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ *
+ * @param workers: the number of worker threads converting the requests
+ * @param memoryCache: the in-memory cache of the recent conversions, or nullptr
+ * @param cache: the conversion cache, or nullptr
+ * @param parent: the parent object
+ */
+ConversionServer::ConversionServer(int workers, MemoryCache *memoryCache, ConversionCache *cache, QObject *parent)
+    : QObject(parent), m_memoryCache(memoryCache), m_cache(cache),
+      m_maxFrameSize(DaemonProtocol::defaultMaxFrameSize), m_nextConnectionId(0)
+{
+    m_pool.setMaxThreadCount(workers > 0 ? workers : QThread::idealThreadCount());
+
+    // Keep the workers alive between requests
+    m_pool.setExpiryTimeout(-1);
+
+    connect(&m_server, &QLocalServer::newConnection, this, &ConversionServer::onNewConnection);
+}
+
+
+/**
+ * @brief Destructor. Drops the queued requests and waits for the running
+ * conversions, which use the caches.
+ */
+ConversionServer::~ConversionServer()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+
+/**
+ * Starts listening on the local socket with the name passed, removing the
+ * socket left by a previous instance. Returns true on success, false otherwise.
+ *
+ * @param name: the local socket name
+ *
+ * @return bool
+ */
+bool ConversionServer::listen(const QString &name)
+{
+    QLocalServer::removeServer(name);
+
+    // Only the user running the daemon can connect
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+
+    return m_server.listen(name);
+}
+
+
+/**
+ * Returns the last error
+ *
+ * @return QString
+ */
+QString ConversionServer::errorString() const
+{
+    return m_server.errorString();
+}
+
+
+/**
+ * Sets the maximum size of the request frames: each connection buffers a
+ * whole frame before it is processed. Connections sending larger frames
+ * are closed.
+ *
+ * @param maxFrameSize: the maximum size of a frame payload, in bytes
+ */
+void ConversionServer::setMaxFrameSize(quint32 maxFrameSize)
+{
+    m_maxFrameSize = maxFrameSize;
+}
+
+
+/**
+ * Accepts the pending connections
+ */
+void ConversionServer::onNewConnection()
+{
+    while(m_server.hasPendingConnections()){
+        QLocalSocket *socket = m_server.nextPendingConnection();
+        quint64 connectionId = ++m_nextConnectionId;
+
+        socket->setProperty("connectionId", connectionId);
+        m_connections.insert(connectionId, socket);
+        m_buffers.insert(socket, QByteArray());
+
+        connect(socket, &QLocalSocket::readyRead, this, &ConversionServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &ConversionServer::onDisconnected);
+    }
+}
+
+
+/**
+ * Reads the requests received on a connection and schedules them on the
+ * worker pool. Requests are processed concurrently, so the responses may
+ * be sent in a different order: clients match them by id.
+ */
+void ConversionServer::onReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if(!socket){
+        return;
+    }
+
+    QByteArray &buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    quint64 connectionId = socket->property("connectionId").toULongLong();
+    QByteArray payload;
+    bool oversized = false;
+
+    while(DaemonProtocol::takeFrame(buffer, payload, m_maxFrameSize, &oversized)){
+        DaemonRequest request;
+
+        // Frames are delimited by their size: a malformed one doesn't affect the next ones
+        if(!DaemonProtocol::request(payload, request)){
+            DaemonResponse response;
+            response.id = request.id;
+            response.code = DaemonResponse::ProtocolError;
+            response.message = "Malformed request";
+
+            socket->write(DaemonProtocol::frame(response));
+            continue;
+        }
+
+        m_pool.start(new ConversionJob(connectionId, request, m_memoryCache, m_cache, this));
+    }
+
+    if(oversized){
+        qWarning() << "Frame exceeds the maximum size, closing connection";
+        socket->abort();
+    }
+}
+
+
+/**
+ * Forgets a closed connection. Responses of its pending requests are dropped.
+ */
+void ConversionServer::onDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if(!socket){
+        return;
+    }
+
+    m_connections.remove(socket->property("connectionId").toULongLong());
+    m_buffers.remove(socket);
+
+    socket->deleteLater();
+}
+
+
+/**
+ * Writes the response frame on the connection, if still open. Receives the
+ * responses posted by the worker threads, in the server thread.
+ *
+ * @param connectionId: the connection on which the request was received
+ * @param frame: the response frame
+ */
+void ConversionServer::onJobFinished(quint64 connectionId, const QByteArray &frame)
+{
+    QLocalSocket *socket = m_connections.value(connectionId);
+
+    if(socket){
+        socket->write(frame);
+    }
+}
+
+}
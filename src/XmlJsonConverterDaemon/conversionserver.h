@@ -0,0 +1,108 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERSIONSERVER_H
+#define CONVERSIONSERVER_H
+
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+
+#include "memorycache.h"
+#include "xmljsonconverter.h"
+
+
+namespace LTDev {
+
+class ConversionServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ConversionServer(int workers, MemoryCache *memoryCache = nullptr, ConversionCache *cache = nullptr,
+                     QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor. Waits for the running conversions.
+     */
+    ~ConversionServer();
+
+    /**
+     * @brief Starts listening on the local socket with the name passed. Returns true on success, false otherwise.
+     */
+    bool listen(const QString &name);
+
+    /**
+     * @brief Returns the last error
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Sets the maximum size of the request frames. Connections sending larger frames are closed.
+     */
+    void setMaxFrameSize(quint32 maxFrameSize);
+
+private slots:
+    /**
+     * @brief Accepts the pending connections
+     */
+    void onNewConnection();
+
+    /**
+     * @brief Reads the requests received on a connection and schedules them
+     */
+    void onReadyRead();
+
+    /**
+     * @brief Forgets a closed connection
+     */
+    void onDisconnected();
+
+    /**
+     * @brief Writes the response frame on the connection, if still open
+     */
+    void onJobFinished(quint64 connectionId, const QByteArray &frame);
+
+private:
+    QLocalServer m_server;
+    QThreadPool m_pool;
+    MemoryCache *m_memoryCache;
+    ConversionCache *m_cache;
+    quint32 m_maxFrameSize;
+
+    // Open connections, by id, and the data received on each of them
+    quint64 m_nextConnectionId;
+    QHash<quint64, QLocalSocket *> m_connections;
+    QHash<QLocalSocket *, QByteArray> m_buffers;
+};
+
+}
+
+#endif // CONVERSIONSERVER_H
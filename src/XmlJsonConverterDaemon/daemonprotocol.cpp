@@ -0,0 +1,233 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "daemonprotocol.h"
+
+#include <QDataStream>
+#include <QStringList>
+#include <QtEndian>
+
+namespace LTDev {
+
+// Frames are made of the payload size (32 bits, big endian) followed by the payload.
+// Each connection buffers a whole frame: files are better sent by path than inline.
+const quint32 DaemonProtocol::defaultMaxFrameSize = 16 * 1024 * 1024;
+
+// Serialization format of the payloads, shared by the daemon and the clients
+static const QDataStream::Version streamVersion = QDataStream::Qt_5_6;
+
+/**
+ * @brief Constructor
+ */
+DaemonRequest::DaemonRequest()
+    : id(0), direction(ToJson)
+{
+
+}
+
+
+/**
+ * @brief Constructor
+ */
+DaemonResponse::DaemonResponse()
+    : id(0), code(0), elapsedUs(0)
+{
+
+}
+
+
+/**
+ * Returns the default name of the daemon local socket
+ *
+ * @return QString
+ */
+QString DaemonProtocol::defaultServerName()
+{
+    return "xmljsonconverter";
+}
+
+
+/**
+ * Returns the frame containing the request
+ *
+ * @param request: the request
+ *
+ * @return QByteArray
+ */
+QByteArray DaemonProtocol::frame(const DaemonRequest &request)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(streamVersion);
+
+    stream << request.id << request.direction << request.options
+           << request.inputPath << request.data << request.outputPath;
+
+    return wrap(payload);
+}
+
+
+/**
+ * Returns the frame containing the response
+ *
+ * @param response: the response
+ *
+ * @return QByteArray
+ */
+QByteArray DaemonProtocol::frame(const DaemonResponse &response)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(streamVersion);
+
+    stream << response.id << response.code << response.message
+           << response.output << response.elapsedUs;
+
+    return wrap(payload);
+}
+
+
+/**
+ * Removes the first complete frame from the buffer. Returns true if a frame
+ * has been taken, false if more data is needed or the frame is oversized.
+ *
+ * @param buffer: the data received so far
+ * @param payload: the payload of the frame, set if a frame has been taken
+ * @param maxFrameSize: the maximum size of the payload
+ * @param oversized: set to true if the next frame exceeds the maximum size, or nullptr
+ *
+ * @return bool
+ */
+bool DaemonProtocol::takeFrame(QByteArray &buffer, QByteArray &payload, quint32 maxFrameSize, bool *oversized)
+{
+    if(oversized){
+        *oversized = false;
+    }
+
+    if(buffer.size() < int(sizeof(quint32))){
+        return false;
+    }
+
+    quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData()));
+
+    if(size > maxFrameSize){
+        if(oversized){
+            *oversized = true;
+        }
+        return false;
+    }
+
+    if(quint32(buffer.size()) - sizeof(quint32) < size){
+        return false;
+    }
+
+    payload = buffer.mid(sizeof(quint32), size);
+    buffer.remove(0, sizeof(quint32) + size);
+
+    return true;
+}
+
+
+/**
+ * Reads the request contained in the frame payload. Returns false if the
+ * payload is truncated, has trailing data, an unknown direction or an
+ * unknown option; the id is set whenever it could be read.
+ *
+ * @param payload: the frame payload
+ * @param request: the request read
+ *
+ * @return bool
+ */
+bool DaemonProtocol::request(const QByteArray &payload, DaemonRequest &request)
+{
+    static const QStringList optionNames = {
+        "compact", "maxInputBytes", "maxElements", "maxDepth",
+        "maxAttributes", "maxTextLength", "maxOutputBytes"
+    };
+
+    request = DaemonRequest();
+
+    QDataStream stream(payload);
+    stream.setVersion(streamVersion);
+
+    stream >> request.id >> request.direction >> request.options
+           >> request.inputPath >> request.data >> request.outputPath;
+
+    if(stream.status() != QDataStream::Ok || !stream.atEnd()){
+        return false;
+    }
+
+    if(request.direction != DaemonRequest::ToJson && request.direction != DaemonRequest::ToXml){
+        return false;
+    }
+
+    foreach (const QString &name, request.options.keys()) {
+        if(!optionNames.contains(name)){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Reads the response contained in the frame payload. Returns false if the
+ * payload is truncated or has trailing data.
+ *
+ * @param payload: the frame payload
+ * @param response: the response read
+ *
+ * @return bool
+ */
+bool DaemonProtocol::response(const QByteArray &payload, DaemonResponse &response)
+{
+    response = DaemonResponse();
+
+    QDataStream stream(payload);
+    stream.setVersion(streamVersion);
+
+    stream >> response.id >> response.code >> response.message
+           >> response.output >> response.elapsedUs;
+
+    return stream.status() == QDataStream::Ok && stream.atEnd();
+}
+
+
+/**
+ * Prepends the payload size to the payload
+ *
+ * @param payload: the payload
+ *
+ * @return QByteArray
+ */
+QByteArray DaemonProtocol::wrap(const QByteArray &payload)
+{
+    QByteArray frame(sizeof(quint32), Qt::Uninitialized);
+    qToBigEndian<quint32>(payload.size(), reinterpret_cast<uchar *>(frame.data()));
+
+    return frame + payload;
+}
+
+}
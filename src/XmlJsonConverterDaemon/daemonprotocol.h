@@ -0,0 +1,173 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DAEMONPROTOCOL_H
+#define DAEMONPROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+
+
+namespace LTDev {
+
+/**
+ * @brief Conversion request sent to the daemon
+ */
+struct DaemonRequest
+{
+    /**
+     * @brief Conversion direction
+     */
+    enum Direction {
+        ToJson,
+        ToXml
+    };
+
+    /**
+     * @brief Constructor
+     */
+    DaemonRequest();
+
+    /**
+     * @brief Request identifier, echoed by the response
+     */
+    quint32 id;
+
+    /**
+     * @brief Conversion direction
+     */
+    quint8 direction;
+
+    /**
+     * @brief Conversion options: "compact" and the ConversionLimits fields. Others are rejected.
+     */
+    QVariantMap options;
+
+    /**
+     * @brief Path of the file to convert. If empty, data is converted.
+     */
+    QString inputPath;
+
+    /**
+     * @brief Inline data to convert
+     */
+    QByteArray data;
+
+    /**
+     * @brief Path of the file in which the daemon writes the output. If empty, the output is sent back.
+     */
+    QString outputPath;
+};
+
+/**
+ * @brief Conversion response sent by the daemon
+ */
+struct DaemonResponse
+{
+    /**
+     * @brief Code of the errors of the protocol, the others are ConversionError codes
+     */
+    enum { ProtocolError = -1 };
+
+    /**
+     * @brief Constructor
+     */
+    DaemonResponse();
+
+    /**
+     * @brief Identifier of the request
+     */
+    quint32 id;
+
+    /**
+     * @brief Error code, 0 on success
+     */
+    qint32 code;
+
+    /**
+     * @brief Error description
+     */
+    QString message;
+
+    /**
+     * @brief Converted data, empty if it has been written into the output path
+     */
+    QByteArray output;
+
+    /**
+     * @brief Conversion time, in microseconds
+     */
+    qint64 elapsedUs;
+};
+
+class DaemonProtocol
+{
+public:
+    /**
+     * @brief Default maximum size of a frame payload
+     */
+    static const quint32 defaultMaxFrameSize;
+
+    /**
+     * @brief Returns the default name of the daemon local socket
+     */
+    static QString defaultServerName();
+
+    /**
+     * @brief Returns the frame containing the request
+     */
+    static QByteArray frame(const DaemonRequest &request);
+
+    /**
+     * @brief Returns the frame containing the response
+     */
+    static QByteArray frame(const DaemonResponse &response);
+
+    /**
+     * @brief Removes the first complete frame from the buffer. Returns true if a frame has been taken.
+     */
+    static bool takeFrame(QByteArray &buffer, QByteArray &payload, quint32 maxFrameSize = defaultMaxFrameSize,
+                          bool *oversized = nullptr);
+
+    /**
+     * @brief Reads the request contained in the frame payload. Returns false if the payload is malformed.
+     */
+    static bool request(const QByteArray &payload, DaemonRequest &request);
+
+    /**
+     * @brief Reads the response contained in the frame payload. Returns false if the payload is malformed.
+     */
+    static bool response(const QByteArray &payload, DaemonResponse &response);
+
+private:
+    /**
+     * @brief Prepends the payload size to the payload
+     */
+    static QByteArray wrap(const QByteArray &payload);
+};
+
+}
+
+#endif // DAEMONPROTOCOL_H
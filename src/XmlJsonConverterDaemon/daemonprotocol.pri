@@ -0,0 +1,11 @@
+# Protocol shared by the daemon and its clients
+QT += network
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/daemonprotocol.cpp
+
+HEADERS += \
+    $$PWD/daemonprotocol.h
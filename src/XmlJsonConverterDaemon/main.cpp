@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+
+#include <limits>
+
+#include "conversionjob.h"
+#include "conversionserver.h"
+#include "xmljsonconverter.h"
+
+/**
+ * @brief Converts a single file in this process and exits, as a cold conversion process does.
+ * Used as baseline by the benchmark.
+ *
+ * @param parser: the parsed command line
+ *
+ * @return int
+ */
+int convertOnce(const QCommandLineParser &parser){
+    QStringList args = parser.positionalArguments();
+    if(args.isEmpty()){
+        qCritical() << "Missing input file";
+        return 1;
+    }
+
+    LTDev::DaemonRequest request;
+    request.direction = parser.isSet("to-xml") ? LTDev::DaemonRequest::ToXml : LTDev::DaemonRequest::ToJson;
+    request.options.insert("compact", parser.isSet("compact"));
+    request.inputPath = args.at(0);
+    request.outputPath = args.value(1);
+
+    LTDev::DaemonResponse response = LTDev::ConversionJob::process(request, nullptr, nullptr);
+    if(response.code != 0){
+        qCritical().noquote() << response.message;
+        return 1;
+    }
+
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+    out.write(response.output);
+
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("XmlJsonConverterDaemon");
+    QCoreApplication::setApplicationVersion(LTDev::XmlJsonConverter::version());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Converts XML and JSON files requested through a local socket.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"name", "Name of the local socket.", "name", LTDev::DaemonProtocol::defaultServerName()},
+        {{"j", "jobs"}, "Number of worker threads, all the cores if 0.", "jobs", "0"},
+        {"memory-cache-size", "Maximum size of the in-memory cache of the recent conversions, in MB. Disabled if 0.", "mb", "64"},
+        {"cache-dir", "Directory of the conversion cache, disabled if empty.", "dir"},
+        {"cache-size", "Maximum size of the conversion cache, in MB.", "mb", "256"},
+        {"max-frame-size", "Maximum size of a request, in KB. Send large files by path.", "kb",
+         QString::number(LTDev::DaemonProtocol::defaultMaxFrameSize / 1024)},
+        {"once", "Convert the input file in this process and exit."},
+        {"to-xml", "With --once: convert json into xml."},
+        {"compact", "With --once: write compact output."}
+    });
+    parser.addPositionalArgument("input", "With --once: the file to convert.", "[input]");
+    parser.addPositionalArgument("output", "With --once: the converted file, stdout if omitted.", "[output]");
+
+    parser.process(a);
+
+    if(parser.isSet("once")){
+        return convertOnce(parser);
+    }
+
+    QScopedPointer<LTDev::MemoryCache> memoryCache;
+    qint64 memoryCacheSize = parser.value("memory-cache-size").toLongLong() * 1024 * 1024;
+    if(memoryCacheSize > 0){
+        memoryCache.reset(new LTDev::MemoryCache(memoryCacheSize));
+    }
+
+    QScopedPointer<LTDev::ConversionCache> cache;
+    if(parser.isSet("cache-dir")){
+        cache.reset(new LTDev::ConversionCache(parser.value("cache-dir"), parser.value("cache-size").toLongLong() * 1024 * 1024));
+    }
+
+    bool ok = false;
+    quint64 maxFrameSize = parser.value("max-frame-size").toULongLong(&ok) * 1024;
+    if(!ok || maxFrameSize == 0 || maxFrameSize > std::numeric_limits<quint32>::max()){
+        qCritical().noquote() << "Invalid maximum frame size:" << parser.value("max-frame-size");
+        return 1;
+    }
+
+    LTDev::ConversionServer server(parser.value("jobs").toInt(), memoryCache.data(), cache.data());
+    server.setMaxFrameSize(quint32(maxFrameSize));
+
+    if(!server.listen(parser.value("name"))){
+        qCritical().noquote() << "Error while listening:" << server.errorString();
+        return 1;
+    }
+
+    qInfo().noquote() << "Listening on" << parser.value("name");
+
+    return a.exec();
+}
@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "memorycache.h"
+
+#include <QMutexLocker>
+
+#include <limits>
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ *
+ * @param maxSize: the maximum size in bytes of the stored entries
+ */
+MemoryCache::MemoryCache(qint64 maxSize)
+    : m_entries(int(qMin<qint64>(maxSize / 1024, std::numeric_limits<int>::max())))
+{
+
+}
+
+
+/**
+ * Retrieves the output stored for the key passed, marking the entry as the
+ * most recently used. Returns true on hit, false otherwise.
+ *
+ * @param key: the cache key, as returned by ConversionCache::key
+ * @param output: set to the stored output on hit
+ *
+ * @return bool
+ */
+bool MemoryCache::find(const QByteArray &key, QByteArray &output)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QByteArray *entry = m_entries.object(key);
+    if(!entry){
+        return false;
+    }
+
+    // Implicitly shared: no copy of the output
+    output = *entry;
+
+    return true;
+}
+
+
+/**
+ * Stores the output for the key passed, evicting the least recently used
+ * entries if needed. Outputs larger than the cache aren't stored.
+ *
+ * @param key: the cache key, as returned by ConversionCache::key
+ * @param output: the converted output
+ */
+void MemoryCache::insert(const QByteArray &key, const QByteArray &output)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_entries.insert(key, new QByteArray(output), output.size() / 1024 + 1);
+}
+
+
+/**
+ * Returns the maximum size in bytes of the stored entries
+ *
+ * @return qint64
+ */
+qint64 MemoryCache::maxSize() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return qint64(m_entries.maxCost()) * 1024;
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MEMORYCACHE_H
+#define MEMORYCACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+
+
+namespace LTDev {
+
+class MemoryCache
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    MemoryCache(qint64 maxSize = 64 * 1024 * 1024);
+
+    /**
+     * @brief Retrieves the output stored for the key passed. Returns true on hit, false otherwise.
+     */
+    bool find(const QByteArray &key, QByteArray &output);
+
+    /**
+     * @brief Stores the output for the key passed, evicting the least recently used entries if needed
+     */
+    void insert(const QByteArray &key, const QByteArray &output);
+
+    /**
+     * @brief Returns the maximum size in bytes of the stored entries
+     */
+    qint64 maxSize() const;
+
+private:
+    // Costs are in KB, since QCache costs are int
+    QCache<QByteArray, QByteArray> m_entries;
+
+    mutable QMutex m_mutex;
+};
+
+}
+
+#endif // MEMORYCACHE_H
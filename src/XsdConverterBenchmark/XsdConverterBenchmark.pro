@@ -0,0 +1,25 @@
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+        main.cpp
+
+# Include library files
+include(../qt-xml-json-library/qt-xml-json-library.pri)
+
+# Generate the converters specialized for the shiporder schema, untyped and typed
+include(../XsdConverterGenerator/xsd2cpp.pri)
+
+XSD_SOURCES += \
+    ../XmlJsonConverterSample/samples/4_sample_xsd_shiporder.xsd
+
+XSD_TYPED_SOURCES += \
+    ../XmlJsonConverterSample/samples/4_sample_xsd_shiporder.xsd
@@ -0,0 +1,162 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include "xmljsonconverter.h"
+#include "4_sample_xsd_shiporder_converter.h"
+#include "4_sample_xsd_shiporder_typed_converter.h"
+
+/**
+ * @brief Returns a shiporder document, valid for the sample schema, having the number of items passed
+ *
+ * @param items: the number of items
+ *
+ * @return QString
+ */
+QString shiporder(int items){
+    QString xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<shiporder orderid=\"889923\">\n"
+                  "  <orderperson>John Smith</orderperson>\n"
+                  "  <shipto>\n"
+                  "    <name>Ola Nordmann</name>\n"
+                  "    <address>Langgt 23</address>\n"
+                  "    <city>4000 Stavanger</city>\n"
+                  "    <country>Norway</country>\n"
+                  "  </shipto>\n";
+
+    for(int i = 0; i < items; i++){
+        xml += "  <item>\n";
+        xml += QString("    <title>Title %1</title>\n").arg(i);
+        if(i % 2 == 0){
+            xml += "    <note>Special Edition</note>\n";
+        }
+        xml += QString("    <quantity>%1</quantity>\n").arg(i % 10 + 1);
+        xml += QString("    <price>%1.90</price>\n").arg(i % 100);
+        xml += "  </item>\n";
+    }
+
+    xml += "</shiporder>\n";
+
+    return xml;
+}
+
+/**
+ * @brief Runs the function the number of times passed, and returns the average time in microseconds
+ *
+ * @param f: the function to measure
+ * @param runs: the number of runs
+ *
+ * @return double
+ */
+template<typename F>
+double measure(F f, int runs){
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int i = 0; i < runs; i++){
+        f();
+    }
+
+    return timer.nsecsElapsed() / 1000.0 / runs;
+}
+
+/**
+ * @brief Prints the comparison between the generic, the specialized and the typed specialized conversions
+ *
+ * @param name: the conversion name
+ * @param genericUs: the average time of the generic conversion
+ * @param specializedUs: the average time of the specialized conversion
+ * @param typedUs: the average time of the typed specialized conversion
+ */
+void report(const QString &name, double genericUs, double specializedUs, double typedUs){
+    qInfo().noquote() << QString("%1: generic %2 us, specialized %3 us (%4x), typed %5 us (%6x)")
+                         .arg(name, -12)
+                         .arg(genericUs, 0, 'f', 1)
+                         .arg(specializedUs, 0, 'f', 1)
+                         .arg(genericUs / specializedUs, 0, 'f', 2)
+                         .arg(typedUs, 0, 'f', 1)
+                         .arg(genericUs / typedUs, 0, 'f', 2);
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    int items = argc > 1 ? QString(argv[1]).toInt() : 10000;
+    int runs = argc > 2 ? QString(argv[2]).toInt() : 20;
+
+    QDomDocument xmlDoc;
+    xmlDoc.setContent(shiporder(items));
+
+    ShiporderConverter converter;
+    ShiporderTypedConverter typedConverter;
+
+    qInfo().noquote() << QString("Shiporder document: %1 items, %2 runs").arg(items).arg(runs);
+
+    // The specialized conversions are measured through XmlJsonConverter, as they are used
+    QJsonObject genericJson = LTDev::XmlToJson::convert(xmlDoc);
+    QDomDocument genericXmlDoc = LTDev::JsonToXml::convert(genericJson);
+
+    LTDev::XmlJsonConverter::registerSchema(&typedConverter);
+    QJsonObject typedJson = LTDev::XmlJsonConverter::toJson(xmlDoc);
+    QDomDocument typedXmlDoc = LTDev::XmlJsonConverter::toXml(typedJson);
+
+    LTDev::XmlJsonConverter::registerSchema(&converter);
+    QJsonObject specializedJson = LTDev::XmlJsonConverter::toJson(xmlDoc);
+    QDomDocument specializedXmlDoc = LTDev::XmlJsonConverter::toXml(specializedJson);
+
+    // The specialized paths must produce the same json, and all the paths the same xml
+    if(specializedJson != genericJson){
+        qCritical() << "The specialized conversion differs from the generic one";
+        return 1;
+    }
+
+    if(specializedXmlDoc.toString() != genericXmlDoc.toString() || typedXmlDoc.toString() != genericXmlDoc.toString()){
+        qCritical() << "The xml converted back differs from the generic one";
+        return 1;
+    }
+
+    double genericUs = measure([&]() { LTDev::XmlToJson::convert(xmlDoc); }, runs);
+    double specializedUs = measure([&]() { LTDev::XmlJsonConverter::toJson(xmlDoc); }, runs);
+
+    LTDev::XmlJsonConverter::registerSchema(&typedConverter);
+    double typedUs = measure([&]() { LTDev::XmlJsonConverter::toJson(xmlDoc); }, runs);
+
+    report("xml -> json", genericUs, specializedUs, typedUs);
+
+    genericUs = measure([&]() { LTDev::JsonToXml::convert(genericJson); }, runs);
+    typedUs = measure([&]() { LTDev::XmlJsonConverter::toXml(typedJson); }, runs);
+
+    LTDev::XmlJsonConverter::registerSchema(&converter);
+    specializedUs = measure([&]() { LTDev::XmlJsonConverter::toXml(genericJson); }, runs);
+
+    report("json -> xml", genericUs, specializedUs, typedUs);
+
+    LTDev::XmlJsonConverter::unregisterSchema(converter.rootTag());
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = xsd2cpp
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+        convertergenerator.cpp \
+        main.cpp \
+        xsdschema.cpp
+
+HEADERS += \
+        convertergenerator.h \
+        xsdschema.h
+
+# Include library files
+include(../qt-xml-json-library/qt-xml-json-library.pri)
@@ -0,0 +1,719 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "convertergenerator.h"
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ *
+ * @param schema: the loaded schema
+ * @param className: the name of the generated class
+ * @param id: the converter identifier, returned by the generated class
+ * @param typed: true if numbers and booleans are emitted as json types
+ */
+ConverterGenerator::ConverterGenerator(const XsdSchema &schema, const QString &className, const QString &id, bool typed)
+    : m_schema(schema), m_className(className), m_id(id), m_typed(typed)
+{
+    // Build the tags table: the root first, then the children in declaration order
+    m_tags.append(schema.rootName());
+    m_tagIndexes.insert(schema.rootName(), 0);
+    m_labels.insert(schema.rootType(), schema.rootName());
+
+    const QList<XsdSchema::Type> &types = schema.types();
+
+    for(int i = 0; i < types.size(); i++){
+        if(!types.at(i).name.isEmpty()){
+            m_labels.insert(i, "type " + types.at(i).name);
+        }
+
+        foreach (const XsdSchema::Particle &particle, types.at(i).children) {
+            if(!m_tagIndexes.contains(particle.name)){
+                m_tagIndexes.insert(particle.name, m_tags.size());
+                m_tags.append(particle.name);
+            }
+
+            if(!m_labels.contains(particle.type)){
+                m_labels.insert(particle.type, particle.name);
+            }
+        }
+    }
+
+    // Collect the complex types reachable from the root, the only ones converted:
+    // base types inherited by an extension are never converted on their own
+    int root = schema.rootType();
+    m_hasChildren = false;
+    m_hasLeaves = root >= 0 && !types.at(root).complex;
+
+    if(root >= 0 && types.at(root).complex){
+        m_conversions.append(root);
+    }
+
+    for(int i = 0; i < m_conversions.size(); i++){
+        const XsdSchema::Type &type = types.at(m_conversions.at(i));
+
+        foreach (const XsdSchema::Particle &particle, type.children) {
+            m_hasChildren = true;
+
+            if(particle.type < 0){
+                continue;
+            }
+
+            if(!types.at(particle.type).complex){
+                m_hasLeaves = true;
+            } else if(!m_conversions.contains(particle.type)){
+                m_conversions.append(particle.type);
+            }
+        }
+    }
+}
+
+
+/**
+ * Returns the content of the header declaring the converter class
+ *
+ * @param includeGuard: the include guard macro
+ *
+ * @return QString
+ */
+QString ConverterGenerator::header(const QString &includeGuard) const
+{
+    QString content;
+    QTextStream out(&content);
+
+    out << "// Generated by xsd2cpp. Do not edit.\n"
+        << "\n"
+        << "#ifndef " << includeGuard << "\n"
+        << "#define " << includeGuard << "\n"
+        << "\n"
+        << "#include \"cpp/schemaconverter.h\"\n"
+        << "\n"
+        << "\n"
+        << "class " << m_className << " : public LTDev::SchemaConverter\n"
+        << "{\n"
+        << "public:\n"
+        << "    QString rootTag() const override;\n"
+        << "    QString id() const override;\n"
+        << "    QJsonObject toJson(const QDomElement &xmlElement) const override;\n"
+        << "    QDomElement toXml(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj) const override;\n"
+        << "};\n"
+        << "\n"
+        << "#endif // " << includeGuard << "\n";
+
+    return content;
+}
+
+
+/**
+ * Returns the content of the source defining the converter class
+ *
+ * @param headerName: the name of the generated header
+ * @param xsdName: the name of the XSD file, used in the generated comments
+ *
+ * @return QString
+ */
+QString ConverterGenerator::source(const QString &headerName, const QString &xsdName) const
+{
+    QString content;
+    QTextStream out(&content);
+
+    const QList<XsdSchema::Type> &types = m_schema.types();
+    int root = m_schema.rootType();
+
+    out << "// Generated by xsd2cpp from " << xsdName << ". Do not edit.\n"
+        << "\n"
+        << "#include \"" << headerName << "\"\n"
+        << "\n"
+        << "#include <QHash>\n"
+        << "#include <qnumeric.h>\n"
+        << "\n"
+        << "namespace {\n"
+        << "\n"
+        << "enum ValueType {\n"
+        << "    StringValue,\n"
+        << "    IntegerValue,\n"
+        << "    DecimalValue,\n"
+        << "    BooleanValue\n"
+        << "};\n"
+        << "\n";
+
+    if(root >= 0){
+        out << "// True if numbers and booleans are emitted as json types\n"
+            << "const bool typed = " << (m_typed ? "true" : "false") << ";\n"
+            << "\n";
+    }
+
+    out << "// Json keys\n"
+        << "const QString tagKey = QStringLiteral(\"tag\");\n"
+        << "const QString attributesKey = QStringLiteral(\"attributes\");\n"
+        << "const QString elementsKey = QStringLiteral(\"elements\");\n"
+        << "const QString textKey = QStringLiteral(\"text\");\n"
+        << "const QString keyKey = QStringLiteral(\"key\");\n"
+        << "const QString valueKey = QStringLiteral(\"value\");\n"
+        << "\n"
+        << "// Element tags\n"
+        << "const QString tags[] = {\n";
+
+    for(int i = 0; i < m_tags.size(); i++){
+        out << "    QStringLiteral(\"" << m_tags.at(i) << "\")" << (i < m_tags.size() - 1 ? "," : "") << "\n";
+    }
+
+    out << "};\n";
+
+    if(m_hasChildren){
+        out << "const int tagCount = " << m_tags.size() << ";\n";
+    }
+
+    out << "\n";
+
+    writeHelpers(out);
+
+    // Declarations first, since the conversions of recursive types call each other
+    foreach (int type, m_conversions) {
+        out << "QJsonObject toJson_" << type << "(const QDomElement &xmlElement, const QString &tag, bool hasText);\n"
+            << "QDomElement toXml_" << type << "(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj, const QString &tag);\n";
+    }
+    out << "\n";
+
+    foreach (int type, m_conversions) {
+        writeToJson(out, type);
+        writeToXml(out, type);
+    }
+
+    out << "}\n"
+        << "\n";
+
+    // Converter class. Elements with another tag, passed directly to the
+    // converter, are converted with the generic path.
+    out << "QString " << m_className << "::rootTag() const\n"
+        << "{\n"
+        << "    return tags[0];\n"
+        << "}\n"
+        << "\n"
+        << "QString " << m_className << "::id() const\n"
+        << "{\n"
+        << "    return QStringLiteral(\"" << m_id << "\");\n"
+        << "}\n"
+        << "\n"
+        << "QJsonObject " << m_className << "::toJson(const QDomElement &xmlElement) const\n"
+        << "{\n";
+
+    if(root < 0){
+        out << "    return LTDev::XmlToJson::convert(xmlElement);\n";
+    } else {
+        out << "    if(xmlElement.tagName() != tags[0]){\n"
+            << "        return LTDev::XmlToJson::convert(xmlElement);\n"
+            << "    }\n"
+            << "\n";
+
+        if(types.at(root).complex){
+            out << "    return toJson_" << root << "(xmlElement, tags[0], false);\n";
+        } else {
+            out << "    return leafToJson(xmlElement, tags[0], " << valueTypeName(types.at(root).valueType) << ", false);\n";
+        }
+    }
+
+    out << "}\n"
+        << "\n"
+        << "QDomElement " << m_className << "::toXml(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj) const\n"
+        << "{\n";
+
+    if(root < 0){
+        out << "    return genericToXml(doc, node, jsonObj);\n";
+    } else {
+        out << "    if(jsonObj.value(tagKey).toString() != tags[0]){\n"
+            << "        return genericToXml(doc, node, jsonObj);\n"
+            << "    }\n"
+            << "\n";
+
+        if(types.at(root).complex){
+            out << "    return toXml_" << root << "(doc, node, jsonObj, tags[0]);\n";
+        } else {
+            out << "    return leafToXml(doc, node, jsonObj, tags[0]);\n";
+        }
+    }
+
+    out << "}\n";
+
+    return content;
+}
+
+
+/**
+ * Writes the helper functions shared by the generated conversions. Only the
+ * helpers used by the schema are written, so that the generated source
+ * compiles without unused function warnings.
+ *
+ * @param out: the stream to write into
+ */
+void ConverterGenerator::writeHelpers(QTextStream &out) const
+{
+    out << R"(// Converts a json object not declared by the schema, as JsonToXml does, adding its nodes straight into the document
+QDomElement genericToXml(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj)
+{
+    return LTDev::JsonToXml::convert(doc, node, jsonObj);
+}
+
+)";
+
+    if(m_schema.rootType() < 0){
+        return;
+    }
+
+    out << R"(// Returns the xml text of the json value, as JsonToXml does. Returns a null string if the value is missing.
+QString textValue(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::String:
+        return value.toString();
+    case QJsonValue::Double:
+        return value.toVariant().toString();
+    case QJsonValue::Bool:
+        return value.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    default:
+        return QString();
+    }
+}
+
+// Returns the json value of the text, typed according to the schema. A value is typed
+// only if it is the canonical form of the number or boolean, the one written back by
+// the conversion to xml: "10.90", "007" or "1" are kept as strings, so no text is lost.
+QJsonValue typedValue(const QString &text, ValueType type)
+{
+    if(!typed){
+        return text;
+    }
+
+    bool ok = false;
+
+    switch (type) {
+    case IntegerValue: {
+        // Integers not exactly representable as json numbers are kept as strings
+        qlonglong value = text.toLongLong(&ok);
+        if(ok && value >= -(1LL << 53) && value <= (1LL << 53) && textValue(double(value)) == text){
+            return double(value);
+        }
+        break;
+    }
+    case DecimalValue: {
+        double value = text.toDouble(&ok);
+        if(ok && qIsFinite(value) && textValue(value) == text){
+            return value;
+        }
+        break;
+    }
+    case BooleanValue:
+        if(text == QLatin1String("true")){
+            return true;
+        }
+        if(text == QLatin1String("false")){
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+// Returns the array of the element's attributes, typing the declared ones
+QJsonArray attributes(const QDomElement &xmlElement, const QString *names, const ValueType *types, int count)
+{
+    QJsonArray jsonAttributes;
+    QDomNamedNodeMap map = xmlElement.attributes();
+
+    for(int i = 0; i < map.size(); i++){
+        QDomAttr attr = map.item(i).toAttr();
+        if(attr.isNull()){
+            continue;
+        }
+
+        QString name = attr.name();
+        ValueType type = StringValue;
+
+        for(int j = 0; j < count; j++){
+            if(names[j] == name){
+                type = types[j];
+                break;
+            }
+        }
+
+        jsonAttributes.append(QJsonObject{
+            {keyKey, name},
+            {valueKey, typedValue(attr.value(), type)}
+        });
+    }
+
+    return jsonAttributes;
+}
+
+// Converts an element not declared by the schema, as XmlToJson does
+QJsonObject genericToJson(const QDomElement &xmlElement, bool hasText)
+{
+    QJsonObject jsonElement = LTDev::XmlToJson::convert(xmlElement);
+
+    // Insert text if the current element hasn't children
+    if(hasText && xmlElement.firstChild().toElement().isNull()){
+        jsonElement.insert(textKey, xmlElement.text());
+    }
+
+    return jsonElement;
+}
+
+// Adds to the node the element with the text and the attributes of the json object, as JsonToXml does
+QDomElement addElement(QDomDocument &doc, QDomNode &node, const QString &tag, const QJsonObject &jsonObj)
+{
+    QDomElement el = doc.createElement(tag);
+    node.appendChild(el);
+
+    QString text = textValue(jsonObj.value(textKey));
+    if(!text.isNull()){
+        el.appendChild(doc.createTextNode(text));
+    }
+
+    const QJsonArray jsonAttributes = jsonObj.value(attributesKey).toArray();
+    for(const QJsonValue &v : jsonAttributes){
+        QJsonObject attr = v.toObject();
+        el.setAttribute(attr.value(keyKey).toString(), textValue(attr.value(valueKey)));
+    }
+
+    return el;
+}
+
+)";
+
+    if(m_hasChildren){
+        out << R"(// Returns the index of the tag in the tags table, -1 if it is not declared
+int tagIndex(const QString &tag)
+{
+    static const QHash<QString, int> indexes = []() {
+        QHash<QString, int> map;
+        for(int i = 0; i < tagCount; i++){
+            map.insert(tags[i], i);
+        }
+        return map;
+    }();
+
+    return indexes.value(tag, -1);
+}
+
+// Returns the position of the child having the tag index passed, -1 if it is not declared.
+// Children declared in a sequence are searched starting from the last matched one.
+int match(int tag, const int *childTags, int count, int from)
+{
+    if(tag < 0){
+        return -1;
+    }
+
+    for(int i = from; i < count; i++){
+        if(childTags[i] == tag){
+            return i;
+        }
+    }
+
+    for(int i = 0; i < from; i++){
+        if(childTags[i] == tag){
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+)";
+    }
+
+    if(m_hasLeaves){
+        out << R"(// Converts an element having a simple type
+QJsonObject leafToJson(const QDomElement &xmlElement, const QString &tag, ValueType type, bool hasText)
+{
+    // Children not allowed by the schema: use the generic conversion
+    if(!xmlElement.firstChildElement().isNull()){
+        return genericToJson(xmlElement, hasText);
+    }
+
+    QJsonObject jsonElement = {
+        {tagKey, tag},
+        {attributesKey, attributes(xmlElement, nullptr, nullptr, 0)},
+        {elementsKey, QJsonArray()}
+    };
+
+    if(hasText){
+        jsonElement.insert(textKey, typedValue(xmlElement.text(), type));
+    }
+
+    return jsonElement;
+}
+
+// Converts the json object of an element having a simple type
+QDomElement leafToXml(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj, const QString &tag)
+{
+    // Children not allowed by the schema: use the generic conversion
+    if(!jsonObj.value(elementsKey).toArray().isEmpty()){
+        return genericToXml(doc, node, jsonObj);
+    }
+
+    return addElement(doc, node, tag, jsonObj);
+}
+
+)";
+    }
+}
+
+
+/**
+ * Writes the xml to json conversion of the complex type passed. The output has
+ * the same structure of the generic conversion, but tags and keys come from the
+ * precomputed tables and children are matched by their tag index against the
+ * declared ones.
+ *
+ * @param out: the stream to write into
+ * @param type: the type index
+ */
+void ConverterGenerator::writeToJson(QTextStream &out, int type) const
+{
+    const XsdSchema::Type &t = m_schema.types().at(type);
+    const QList<XsdSchema::Type> &types = m_schema.types();
+
+    out << "// " << m_labels.value(type) << "\n"
+        << "QJsonObject toJson_" << type << "(const QDomElement &xmlElement, const QString &tag, bool hasText)\n"
+        << "{\n";
+
+    writeAttributeTables(out, t);
+    writeChildTables(out, t);
+
+    out << "    QJsonArray jsonElements;\n";
+    if(!t.children.isEmpty() && t.ordered){
+        out << "    int next = 0;\n";
+    }
+    out << "\n"
+        << "    for(QDomElement e = xmlElement.firstChild().toElement(); !e.isNull(); e = e.nextSibling().toElement()){\n";
+
+    if(t.children.isEmpty()){
+        out << "        jsonElements.append(genericToJson(e, true));\n";
+    } else {
+        out << "        int i = match(tagIndex(e.tagName()), childTags, childCount, " << (t.ordered ? "next" : "0") << ");\n"
+            << "\n"
+            << "        switch (i) {\n";
+
+        for(int i = 0; i < t.children.size(); i++){
+            const XsdSchema::Particle &particle = t.children.at(i);
+            if(particle.type < 0){
+                continue;
+            }
+
+            QString tag = QString("tags[%1]").arg(m_tagIndexes.value(particle.name));
+
+            out << "        case " << i << ":\n";
+            if(types.at(particle.type).complex){
+                out << "            jsonElements.append(toJson_" << particle.type << "(e, " << tag << ", true));\n";
+            } else {
+                out << "            jsonElements.append(leafToJson(e, " << tag << ", "
+                    << valueTypeName(types.at(particle.type).valueType) << ", true));\n";
+            }
+            out << "            break;\n";
+        }
+
+        out << "        default:\n"
+            << "            jsonElements.append(genericToJson(e, true));\n"
+            << "            break;\n"
+            << "        }\n";
+
+        if(t.ordered){
+            out << "\n"
+                << "        if(i >= 0){\n"
+                << "            next = i;\n"
+                << "        }\n";
+        }
+    }
+
+    out << "    }\n"
+        << "\n"
+        << "    QJsonObject jsonElement = {\n"
+        << "        {tagKey, tag},\n";
+
+    if(t.attributes.isEmpty()){
+        out << "        {attributesKey, attributes(xmlElement, nullptr, nullptr, 0)},\n";
+    } else {
+        out << "        {attributesKey, attributes(xmlElement, attributeNames, attributeTypes, " << t.attributes.size() << ")},\n";
+    }
+
+    out << "        {elementsKey, jsonElements}\n"
+        << "    };\n"
+        << "\n"
+        << "    // Insert text if the current element hasn't children\n"
+        << "    if(hasText && xmlElement.firstChild().toElement().isNull()){\n"
+        << "        jsonElement.insert(textKey, typedValue(xmlElement.text(), " << valueTypeName(t.valueType) << "));\n"
+        << "    }\n"
+        << "\n"
+        << "    return jsonElement;\n"
+        << "}\n"
+        << "\n";
+}
+
+
+/**
+ * Writes the json to xml conversion of the complex type passed. The element is
+ * created with the tag of the table, and the children are matched by their tag
+ * index against the declared ones and dispatched to their conversion; only the
+ * children not declared use the generic path.
+ *
+ * @param out: the stream to write into
+ * @param type: the type index
+ */
+void ConverterGenerator::writeToXml(QTextStream &out, int type) const
+{
+    const XsdSchema::Type &t = m_schema.types().at(type);
+    const QList<XsdSchema::Type> &types = m_schema.types();
+
+    out << "// " << m_labels.value(type) << "\n"
+        << "QDomElement toXml_" << type << "(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj, const QString &tag)\n"
+        << "{\n";
+
+    writeChildTables(out, t);
+
+    out << "    QDomElement el = addElement(doc, node, tag, jsonObj);\n"
+        << "    const QJsonArray jsonElements = jsonObj.value(elementsKey).toArray();\n";
+    if(!t.children.isEmpty() && t.ordered){
+        out << "    int next = 0;\n";
+    }
+    out << "\n"
+        << "    for(const QJsonValue &v : jsonElements){\n"
+        << "        QJsonObject obj = v.toObject();\n";
+
+    if(t.children.isEmpty()){
+        out << "        genericToXml(doc, el, obj);\n";
+    } else {
+        out << "        int i = match(tagIndex(obj.value(tagKey).toString()), childTags, childCount, "
+            << (t.ordered ? "next" : "0") << ");\n"
+            << "\n"
+            << "        switch (i) {\n";
+
+        for(int i = 0; i < t.children.size(); i++){
+            const XsdSchema::Particle &particle = t.children.at(i);
+            if(particle.type < 0){
+                continue;
+            }
+
+            QString tag = QString("tags[%1]").arg(m_tagIndexes.value(particle.name));
+
+            out << "        case " << i << ":\n";
+            if(types.at(particle.type).complex){
+                out << "            toXml_" << particle.type << "(doc, el, obj, " << tag << ");\n";
+            } else {
+                out << "            leafToXml(doc, el, obj, " << tag << ");\n";
+            }
+            out << "            break;\n";
+        }
+
+        out << "        default:\n"
+            << "            genericToXml(doc, el, obj);\n"
+            << "            break;\n"
+            << "        }\n";
+
+        if(t.ordered){
+            out << "\n"
+                << "        if(i >= 0){\n"
+                << "            next = i;\n"
+                << "        }\n";
+        }
+    }
+
+    out << "    }\n"
+        << "\n"
+        << "    return el;\n"
+        << "}\n"
+        << "\n";
+}
+
+
+/**
+ * Writes the tables of the names and types of the type's attributes
+ *
+ * @param out: the stream to write into
+ * @param type: the type
+ */
+void ConverterGenerator::writeAttributeTables(QTextStream &out, const XsdSchema::Type &type) const
+{
+    if(type.attributes.isEmpty()){
+        return;
+    }
+
+    QStringList names, valueTypes;
+    foreach (const XsdSchema::Attribute &attribute, type.attributes) {
+        names.append("QStringLiteral(\"" + attribute.name + "\")");
+        valueTypes.append(valueTypeName(attribute.type));
+    }
+
+    out << "    static const QString attributeNames[] = {" << names.join(", ") << "};\n"
+        << "    static const ValueType attributeTypes[] = {" << valueTypes.join(", ") << "};\n";
+}
+
+
+/**
+ * Writes the table of the tags of the type's children
+ *
+ * @param out: the stream to write into
+ * @param type: the type
+ */
+void ConverterGenerator::writeChildTables(QTextStream &out, const XsdSchema::Type &type) const
+{
+    if(type.children.isEmpty()){
+        return;
+    }
+
+    QStringList indexes;
+    foreach (const XsdSchema::Particle &particle, type.children) {
+        indexes.append(QString::number(m_tagIndexes.value(particle.name)));
+    }
+
+    out << "    static const int childTags[] = {" << indexes.join(", ") << "};\n"
+        << "    static const int childCount = " << type.children.size() << ";\n";
+}
+
+
+/**
+ * Returns the C++ name of the value type passed
+ *
+ * @param valueType: the value type
+ *
+ * @return QString
+ */
+QString ConverterGenerator::valueTypeName(XsdSchema::ValueType valueType)
+{
+    switch (valueType) {
+    case XsdSchema::IntegerValue:
+        return "IntegerValue";
+    case XsdSchema::DecimalValue:
+        return "DecimalValue";
+    case XsdSchema::BooleanValue:
+        return "BooleanValue";
+    default:
+        return "StringValue";
+    }
+}
+
+}
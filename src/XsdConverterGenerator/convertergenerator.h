@@ -0,0 +1,106 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERTERGENERATOR_H
+#define CONVERTERGENERATOR_H
+
+#include "xsdschema.h"
+
+#include <QTextStream>
+
+
+namespace LTDev {
+
+class ConverterGenerator
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    ConverterGenerator(const XsdSchema &schema, const QString &className, const QString &id, bool typed);
+
+    /**
+     * @brief Returns the content of the header declaring the converter class
+     */
+    QString header(const QString &includeGuard) const;
+
+    /**
+     * @brief Returns the content of the source defining the converter class
+     */
+    QString source(const QString &headerName, const QString &xsdName) const;
+
+private:
+    /**
+     * @brief Writes the helper functions used by the generated conversions
+     */
+    void writeHelpers(QTextStream &out) const;
+
+    /**
+     * @brief Writes the xml to json conversion of the complex type passed
+     */
+    void writeToJson(QTextStream &out, int type) const;
+
+    /**
+     * @brief Writes the json to xml conversion of the complex type passed
+     */
+    void writeToXml(QTextStream &out, int type) const;
+
+    /**
+     * @brief Writes the tables of the names and types of the type's attributes
+     */
+    void writeAttributeTables(QTextStream &out, const XsdSchema::Type &type) const;
+
+    /**
+     * @brief Writes the table of the tags of the type's children
+     */
+    void writeChildTables(QTextStream &out, const XsdSchema::Type &type) const;
+
+    /**
+     * @brief Returns the C++ name of the value type passed
+     */
+    static QString valueTypeName(XsdSchema::ValueType valueType);
+
+    const XsdSchema &m_schema;
+    QString m_className;
+    QString m_id;
+    bool m_typed;
+
+    // Element tags table, and the index of each tag in it
+    QStringList m_tags;
+    QHash<QString, int> m_tagIndexes;
+
+    // Description of each type, used in the generated comments
+    QHash<int, QString> m_labels;
+
+    // Complex types reachable from the root, in conversion order
+    QList<int> m_conversions;
+
+    // True if a converted type declares children, and if any of them has a simple type
+    bool m_hasChildren;
+    bool m_hasLeaves;
+};
+
+}
+
+#endif // CONVERTERGENERATOR_H
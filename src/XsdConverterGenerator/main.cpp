@@ -0,0 +1,161 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "convertergenerator.h"
+#include "xsdschema.h"
+
+/**
+ * @brief Returns the default class name of the converter of the root element passed
+ *
+ * @param rootName: the name of the root element
+ * @param suffix: the suffix of the class name
+ *
+ * @return QString
+ */
+QString defaultClassName(const QString &rootName, const QString &suffix){
+    QString className;
+
+    foreach (const QChar &c, rootName) {
+        className.append(c.isLetterOrNumber() ? c : QChar('_'));
+    }
+
+    if(!className.isEmpty()){
+        className[0] = className.at(0).toUpper();
+    }
+
+    return className + suffix;
+}
+
+/**
+ * @brief Writes the content into the file passed. Returns true on success, false otherwise.
+ *
+ * @param content: the file content
+ * @param filePath: the path of the file to write
+ *
+ * @return bool
+ */
+bool write(const QString &content, const QString &filePath){
+    QFile file(filePath);
+
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)){
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    stream << content;
+
+    return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("xsd2cpp");
+    QCoreApplication::setApplicationVersion(LIBRARY_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates a XML <-> JSON converter specialized for an XSD schema.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption headerOption("header", "Generate the header of the converter.");
+    QCommandLineOption sourceOption("source", "Generate the source of the converter.");
+    QCommandLineOption typedOption("typed", "Emit numbers and booleans as json types.");
+    QCommandLineOption classOption("class", "Name of the generated class.", "name");
+    QCommandLineOption suffixOption("suffix", "Suffix of the default class name, Converter if omitted.", "suffix", "Converter");
+    QCommandLineOption rootOption("root", "Root element, the first global element if omitted.", "element");
+    parser.addOptions({headerOption, sourceOption, typedOption, classOption, suffixOption, rootOption});
+
+    parser.addPositionalArgument("xsd", "The XSD file.");
+    parser.addPositionalArgument("output", "The file to generate.");
+
+    parser.process(a);
+
+    QStringList args = parser.positionalArguments();
+    if(args.size() != 2 || parser.isSet(headerOption) == parser.isSet(sourceOption)){
+        parser.showHelp(1);
+    }
+
+    QString xsdPath = args.at(0);
+    QString outputPath = args.at(1);
+
+    LTDev::XsdSchema schema;
+    if(!schema.load(xsdPath, parser.value(rootOption))){
+        qCritical().noquote() << schema.errorString();
+        return 1;
+    }
+
+    QFile xsdFile(xsdPath);
+    if(!xsdFile.open(QIODevice::ReadOnly)){
+        qCritical().noquote() << "Error while loading file: " << xsdPath;
+        return 1;
+    }
+
+    bool typed = parser.isSet(typedOption);
+    QString className = parser.isSet(classOption)
+            ? parser.value(classOption) : defaultClassName(schema.rootName(), parser.value(suffixOption));
+
+    // The identifier changes whenever the generated output may change
+    QString id = QString("%1:%2:%3%4")
+            .arg(className)
+            .arg(LIBRARY_VERSION)
+            .arg(QString(QCryptographicHash::hash(xsdFile.readAll(), QCryptographicHash::Md5).toHex()))
+            .arg(typed ? ":typed" : "");
+
+    LTDev::ConverterGenerator generator(schema, className, id, typed);
+
+    QFileInfo outputInfo(outputPath);
+    QString content;
+
+    if(parser.isSet(headerOption)){
+        QString guard = outputInfo.fileName().toUpper();
+        for(int i = 0; i < guard.size(); i++){
+            if(!guard.at(i).isLetterOrNumber()){
+                guard[i] = '_';
+            }
+        }
+        if(guard.at(0).isDigit()){
+            guard.prepend("XSD2CPP_");
+        }
+        content = generator.header(guard);
+    } else {
+        content = generator.source(outputInfo.completeBaseName() + ".h", QFileInfo(xsdPath).fileName());
+    }
+
+    if(!write(content, outputPath)){
+        qCritical().noquote() << "Error while writing file: " << outputPath;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+# Generates specialized XML <-> JSON converters from the XSD files listed in XSD_SOURCES.
+#
+# For each schema.xsd the files schema_converter.h and schema_converter.cpp are
+# generated in the build directory, declaring a class derived from
+# LTDev::SchemaConverter that can be registered with XmlJsonConverter::registerSchema.
+#
+# Usage, in the .pro of your project:
+#
+#   include(../qt-xml-json-library/qt-xml-json-library.pri)
+#   include(../XsdConverterGenerator/xsd2cpp.pri)
+#
+#   XSD_SOURCES += schema.xsd
+#   XSD2CPP_FLAGS += --typed          # optional: emit numbers and booleans as json types
+#
+# The schemas listed in XSD_TYPED_SOURCES are generated with --typed into
+# schema_typed_converter.h and schema_typed_converter.cpp, declaring a class named
+# after the root element with the TypedConverter suffix: the same schema can be
+# listed in both variables.
+#
+# The generator must be built before the project: build both from src.pro, or
+# set XSD2CPP to the path of an already built xsd2cpp executable.
+
+isEmpty(XSD2CPP) {
+    XSD2CPP = $$shadowed($$PWD)/xsd2cpp
+    win32: XSD2CPP = $${XSD2CPP}.exe
+}
+
+INCLUDEPATH += $$OUT_PWD
+
+xsd2cpp_header.input = XSD_SOURCES
+xsd2cpp_header.output = ${QMAKE_FILE_BASE}_converter.h
+xsd2cpp_header.commands = $$shell_path($$XSD2CPP) $$XSD2CPP_FLAGS --header ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+xsd2cpp_header.depends = $$XSD2CPP
+xsd2cpp_header.variable_out = HEADERS
+xsd2cpp_header.CONFIG += target_predeps no_link
+
+xsd2cpp_source.input = XSD_SOURCES
+xsd2cpp_source.output = ${QMAKE_FILE_BASE}_converter.cpp
+xsd2cpp_source.commands = $$shell_path($$XSD2CPP) $$XSD2CPP_FLAGS --source ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+xsd2cpp_source.depends = $$XSD2CPP ${QMAKE_FILE_BASE}_converter.h
+xsd2cpp_source.variable_out = GENERATED_SOURCES
+
+QMAKE_EXTRA_COMPILERS += xsd2cpp_header xsd2cpp_source
+
+xsd2cpp_typed_header.input = XSD_TYPED_SOURCES
+xsd2cpp_typed_header.output = ${QMAKE_FILE_BASE}_typed_converter.h
+xsd2cpp_typed_header.commands = $$shell_path($$XSD2CPP) $$XSD2CPP_FLAGS --typed --suffix TypedConverter --header ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+xsd2cpp_typed_header.depends = $$XSD2CPP
+xsd2cpp_typed_header.variable_out = HEADERS
+xsd2cpp_typed_header.CONFIG += target_predeps no_link
+
+xsd2cpp_typed_source.input = XSD_TYPED_SOURCES
+xsd2cpp_typed_source.output = ${QMAKE_FILE_BASE}_typed_converter.cpp
+xsd2cpp_typed_source.commands = $$shell_path($$XSD2CPP) $$XSD2CPP_FLAGS --typed --suffix TypedConverter --source ${QMAKE_FILE_NAME} ${QMAKE_FILE_OUT}
+xsd2cpp_typed_source.depends = $$XSD2CPP ${QMAKE_FILE_BASE}_typed_converter.h
+xsd2cpp_typed_source.variable_out = GENERATED_SOURCES
+
+QMAKE_EXTRA_COMPILERS += xsd2cpp_typed_header xsd2cpp_typed_source
@@ -0,0 +1,436 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "xsdschema.h"
+
+#include <QFile>
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ */
+XsdSchema::XsdSchema()
+    : m_rootType(-1)
+{
+
+}
+
+
+/**
+ * Loads the XSD file, resolving the types of the root element and of all the
+ * elements reachable from it. Returns true on success, false otherwise.
+ *
+ * @param xsdFilePath: the path of the XSD file
+ * @param rootName: the name of the root element, the first global element if empty
+ *
+ * @return bool
+ */
+bool XsdSchema::load(const QString &xsdFilePath, const QString &rootName)
+{
+    QFile f(xsdFilePath);
+    if(!f.open(QIODevice::ReadOnly)){
+        m_error = "Error while loading file: " + xsdFilePath;
+        return false;
+    }
+
+    QDomDocument xsdDoc;
+    QString parseError;
+    int line = 0, column = 0;
+
+    // Namespace processing is needed to recognize the schema elements regardless of their prefix
+    if(!xsdDoc.setContent(&f, true, &parseError, &line, &column)){
+        m_error = QString("%1:%2:%3: %4").arg(xsdFilePath).arg(line).arg(column).arg(parseError);
+        return false;
+    }
+    f.close();
+
+    QDomElement schema = xsdDoc.documentElement();
+    QString firstElement;
+
+    // Collect the global declarations
+    for(QDomElement e = schema.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()){
+        QString name = e.attribute("name");
+
+        if(e.localName() == "element"){
+            m_elements.insert(name, e);
+
+            if(firstElement.isEmpty()){
+                firstElement = name;
+            }
+        } else if(e.localName() == "complexType"){
+            m_complexTypes.insert(name, e);
+        } else if(e.localName() == "simpleType"){
+            m_simpleTypes.insert(name, e);
+        }
+    }
+
+    m_rootName = rootName.isEmpty() ? firstElement : rootName;
+
+    if(!m_elements.contains(m_rootName)){
+        m_error = "Root element not declared: " + m_rootName;
+        return false;
+    }
+
+    m_rootType = elementType(m_elements.value(m_rootName));
+
+    return true;
+}
+
+
+/**
+ * Returns the last error
+ *
+ * @return QString
+ */
+QString XsdSchema::errorString() const
+{
+    return m_error;
+}
+
+
+/**
+ * Returns the name of the root element
+ *
+ * @return QString
+ */
+QString XsdSchema::rootName() const
+{
+    return m_rootName;
+}
+
+
+/**
+ * Returns the type index of the root element, negative if the root element has no known type
+ *
+ * @return int
+ */
+int XsdSchema::rootType() const
+{
+    return m_rootType;
+}
+
+
+/**
+ * Returns the element types
+ *
+ * @return const QList<Type>&
+ */
+const QList<XsdSchema::Type> &XsdSchema::types() const
+{
+    return m_types;
+}
+
+
+/**
+ * Returns the value type of the XSD built-in type passed
+ *
+ * @param typeName: the built-in type name, with or without prefix
+ *
+ * @return ValueType
+ */
+XsdSchema::ValueType XsdSchema::builtinType(const QString &typeName)
+{
+    static const QStringList integers = {
+        "integer", "int", "long", "short", "byte",
+        "nonNegativeInteger", "positiveInteger", "nonPositiveInteger", "negativeInteger",
+        "unsignedLong", "unsignedInt", "unsignedShort", "unsignedByte"
+    };
+    static const QStringList decimals = {"decimal", "float", "double"};
+
+    QString name = localName(typeName);
+
+    if(integers.contains(name)){
+        return IntegerValue;
+    }
+    if(decimals.contains(name)){
+        return DecimalValue;
+    }
+    if(name == "boolean"){
+        return BooleanValue;
+    }
+
+    return StringValue;
+}
+
+
+/**
+ * Returns the type index of the element declaration, negative if the
+ * element has no known type
+ *
+ * @param xsdElement: the element declaration
+ *
+ * @return int
+ */
+int XsdSchema::elementType(const QDomElement &xsdElement)
+{
+    // Reference to a global element
+    if(xsdElement.hasAttribute("ref")){
+        QString name = localName(xsdElement.attribute("ref"));
+
+        if(!m_elements.contains(name)){
+            qWarning() << "Element not declared: " << name;
+            return -1;
+        }
+
+        return elementType(m_elements.value(name));
+    }
+
+    if(xsdElement.hasAttribute("type")){
+        return namedType(xsdElement.attribute("type"));
+    }
+
+    for(QDomElement e = xsdElement.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()){
+        if(e.localName() == "complexType"){
+            return complexType(e, QString());
+        }
+        if(e.localName() == "simpleType"){
+            return simpleType(simpleTypeValue(e));
+        }
+    }
+
+    // xs:anyType
+    return -1;
+}
+
+
+/**
+ * Returns the type index of the named type
+ *
+ * @param typeName: the type name, with or without prefix
+ *
+ * @return int
+ */
+int XsdSchema::namedType(const QString &typeName)
+{
+    QString name = localName(typeName);
+
+    if(m_complexTypes.contains(name)){
+        return complexType(m_complexTypes.value(name), name);
+    }
+
+    if(m_simpleTypes.contains(name)){
+        return simpleType(simpleTypeValue(m_simpleTypes.value(name)));
+    }
+
+    if(name == "anyType"){
+        return -1;
+    }
+
+    return simpleType(builtinType(name));
+}
+
+
+/**
+ * Returns the type index of the simple type with the value type passed
+ *
+ * @param valueType: the value type
+ *
+ * @return int
+ */
+int XsdSchema::simpleType(ValueType valueType)
+{
+    if(m_simpleTypeIndexes.contains(valueType)){
+        return m_simpleTypeIndexes.value(valueType);
+    }
+
+    Type type;
+    type.complex = false;
+    type.ordered = true;
+    type.valueType = valueType;
+
+    m_types.append(type);
+    m_simpleTypeIndexes.insert(valueType, m_types.size() - 1);
+
+    return m_types.size() - 1;
+}
+
+
+/**
+ * Returns the value type of the simple type declaration, following its restriction base
+ *
+ * @param xsdSimpleType: the simple type declaration
+ *
+ * @return ValueType
+ */
+XsdSchema::ValueType XsdSchema::simpleTypeValue(const QDomElement &xsdSimpleType)
+{
+    for(QDomElement e = xsdSimpleType.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()){
+        if(e.localName() != "restriction"){
+            continue;
+        }
+
+        QString base = localName(e.attribute("base"));
+        if(m_simpleTypes.contains(base)){
+            return simpleTypeValue(m_simpleTypes.value(base));
+        }
+
+        return builtinType(base);
+    }
+
+    // Lists and unions are kept as strings
+    return StringValue;
+}
+
+
+/**
+ * Returns the type index of the complex type declaration. The index is reserved
+ * before reading the content, so that recursive types are resolved once.
+ *
+ * @param xsdComplexType: the complex type declaration
+ * @param name: the type name, empty for anonymous types
+ *
+ * @return int
+ */
+int XsdSchema::complexType(const QDomElement &xsdComplexType, const QString &name)
+{
+    // Anonymous types are identified by their position in the schema
+    QString key = name.isEmpty()
+            ? QString("anonymous:%1:%2").arg(xsdComplexType.lineNumber()).arg(xsdComplexType.columnNumber())
+            : "type:" + name;
+
+    if(m_namedTypes.contains(key)){
+        return m_namedTypes.value(key);
+    }
+
+    Type type;
+    type.name = name;
+    type.complex = true;
+    type.ordered = true;
+    type.valueType = StringValue;
+
+    m_types.append(type);
+    int index = m_types.size() - 1;
+    m_namedTypes.insert(key, index);
+
+    addContent(index, xsdComplexType);
+
+    return index;
+}
+
+
+/**
+ * Adds to the type the attributes, the children and the simple content
+ * declared in the complex type (or extension) passed
+ *
+ * @param type: the type index
+ * @param xsdContent: the complex type, or extension, declaration
+ */
+void XsdSchema::addContent(int type, const QDomElement &xsdContent)
+{
+    for(QDomElement e = xsdContent.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()){
+        QString kind = e.localName();
+
+        if(kind == "sequence"){
+            addParticles(type, e);
+        } else if(kind == "all" || kind == "choice"){
+            m_types[type].ordered = false;
+            addParticles(type, e);
+        } else if(kind == "attribute"){
+            Attribute attribute;
+            attribute.name = e.hasAttribute("ref") ? localName(e.attribute("ref")) : e.attribute("name");
+            attribute.type = StringValue;
+
+            if(e.hasAttribute("type")){
+                QString typeName = localName(e.attribute("type"));
+                attribute.type = m_simpleTypes.contains(typeName)
+                        ? simpleTypeValue(m_simpleTypes.value(typeName))
+                        : builtinType(typeName);
+            } else if(!e.firstChildElement().isNull()){
+                attribute.type = simpleTypeValue(e.firstChildElement());
+            }
+
+            m_types[type].attributes.append(attribute);
+        } else if(kind == "simpleContent" || kind == "complexContent"){
+            for(QDomElement d = e.firstChildElement(); !d.isNull(); d = d.nextSiblingElement()){
+                if(d.localName() != "extension" && d.localName() != "restriction"){
+                    continue;
+                }
+
+                QString base = localName(d.attribute("base"));
+
+                if(m_complexTypes.contains(base)){
+                    // Inherit the content of the base type
+                    int baseType = complexType(m_complexTypes.value(base), base);
+                    Type inherited = m_types.at(baseType);
+
+                    m_types[type].valueType = inherited.valueType;
+                    m_types[type].ordered = inherited.ordered;
+                    m_types[type].attributes.append(inherited.attributes);
+                    m_types[type].children.append(inherited.children);
+                } else if(m_simpleTypes.contains(base)){
+                    m_types[type].valueType = simpleTypeValue(m_simpleTypes.value(base));
+                } else {
+                    m_types[type].valueType = builtinType(base);
+                }
+
+                addContent(type, d);
+            }
+        } else if(kind == "group" || kind == "attributeGroup" || kind == "anyAttribute"){
+            qWarning() << "Unsupported declaration, converted with the generic path: " << kind;
+        }
+    }
+}
+
+
+/**
+ * Adds to the type the children declared in the model group, flattening the nested groups
+ *
+ * @param type: the type index
+ * @param xsdGroup: the sequence, all or choice declaration
+ */
+void XsdSchema::addParticles(int type, const QDomElement &xsdGroup)
+{
+    for(QDomElement e = xsdGroup.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()){
+        QString kind = e.localName();
+
+        if(kind == "element"){
+            Particle particle;
+            particle.name = e.hasAttribute("ref") ? localName(e.attribute("ref")) : e.attribute("name");
+            particle.type = elementType(e);
+
+            m_types[type].children.append(particle);
+        } else if(kind == "sequence"){
+            addParticles(type, e);
+        } else if(kind == "all" || kind == "choice"){
+            m_types[type].ordered = false;
+            addParticles(type, e);
+        }
+    }
+}
+
+
+/**
+ * Returns the local part of a qualified name
+ *
+ * @param qualifiedName: the qualified name
+ *
+ * @return QString
+ */
+QString XsdSchema::localName(const QString &qualifiedName)
+{
+    return qualifiedName.mid(qualifiedName.indexOf(':') + 1);
+}
+
+}
@@ -0,0 +1,176 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef XSDSCHEMA_H
+#define XSDSCHEMA_H
+
+#include <QDebug>
+
+#include <QDomElement>
+#include <QDomDocument>
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+
+namespace LTDev {
+
+class XsdSchema
+{
+public:
+    /**
+     * @brief Type of the values of simple elements and attributes
+     */
+    enum ValueType {
+        StringValue,
+        IntegerValue,
+        DecimalValue,
+        BooleanValue
+    };
+
+    /**
+     * @brief Attribute declared by a complex type
+     */
+    struct Attribute {
+        QString name;
+        ValueType type;
+    };
+
+    /**
+     * @brief Child element declared by a complex type. A negative type means that
+     * the element has no known type and is converted with the generic path.
+     */
+    struct Particle {
+        QString name;
+        int type;
+    };
+
+    /**
+     * @brief Element type. Simple types have only a value type, complex types
+     * have attributes, children and optionally a simple content.
+     */
+    struct Type {
+        QString name;
+        bool complex;
+        bool ordered;
+        ValueType valueType;
+        QList<Attribute> attributes;
+        QList<Particle> children;
+    };
+
+    /**
+     * @brief Constructor
+     */
+    XsdSchema();
+
+    /**
+     * @brief Loads the XSD file. Returns true on success, false otherwise.
+     */
+    bool load(const QString &xsdFilePath, const QString &rootName = QString());
+
+    /**
+     * @brief Returns the last error
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Returns the name of the root element
+     */
+    QString rootName() const;
+
+    /**
+     * @brief Returns the type index of the root element
+     */
+    int rootType() const;
+
+    /**
+     * @brief Returns the element types
+     */
+    const QList<Type> &types() const;
+
+    /**
+     * @brief Returns the value type of the XSD built-in type passed
+     */
+    static ValueType builtinType(const QString &typeName);
+
+private:
+    /**
+     * @brief Returns the type index of the element declaration
+     */
+    int elementType(const QDomElement &xsdElement);
+
+    /**
+     * @brief Returns the type index of the named type
+     */
+    int namedType(const QString &typeName);
+
+    /**
+     * @brief Returns the type index of the simple type with the value type passed
+     */
+    int simpleType(ValueType valueType);
+
+    /**
+     * @brief Returns the value type of the simple type declaration
+     */
+    ValueType simpleTypeValue(const QDomElement &xsdSimpleType);
+
+    /**
+     * @brief Returns the type index of the complex type declaration
+     */
+    int complexType(const QDomElement &xsdComplexType, const QString &name);
+
+    /**
+     * @brief Adds to the type the content of the complex type declaration
+     */
+    void addContent(int type, const QDomElement &xsdContent);
+
+    /**
+     * @brief Adds to the type the children declared in the model group
+     */
+    void addParticles(int type, const QDomElement &xsdGroup);
+
+    /**
+     * @brief Returns the local part of a qualified name
+     */
+    static QString localName(const QString &qualifiedName);
+
+    QString m_error;
+    QString m_rootName;
+    int m_rootType;
+    QList<Type> m_types;
+
+    // Global declarations, by name
+    QHash<QString, QDomElement> m_elements;
+    QHash<QString, QDomElement> m_complexTypes;
+    QHash<QString, QDomElement> m_simpleTypes;
+
+    // Type indexes already resolved, by name
+    QHash<QString, int> m_namedTypes;
+    QHash<int, int> m_simpleTypeIndexes;
+};
+
+}
+
+#endif // XSDSCHEMA_H
@@ -0,0 +1,332 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "conversioncache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ *
+ * @param dirPath: the directory in which the entries are stored. It is created if missing.
+ * @param maxSize: the maximum size in bytes of the stored entries
+ */
+ConversionCache::ConversionCache(const QString &dirPath, qint64 maxSize)
+    : m_path(dirPath), m_maxSize(maxSize), m_size(0), m_tick(0), m_hits(0), m_misses(0)
+{
+    if(!QDir().mkpath(m_path)){
+        qWarning() << "Error while creating cache directory: " << m_path;
+    }
+
+    load();
+}
+
+
+/**
+ * Returns the cache key of the input passed. The key depends on the input bytes,
+ * the library version, the conversion direction and the conversion options, so
+ * that a library upgrade or a change of options never returns a stale result.
+ * The input is hashed with SHA-1, the fastest digest of QCryptographicHash
+ * after MD4 (faster than MD5 too), whose collisions, unlike the MD4 and MD5
+ * ones, can't be crafted cheaply to make an input read the output of another.
+ *
+ * @param input: the raw bytes to convert
+ * @param direction: the conversion direction
+ * @param options: the serialized conversion options
+ *
+ * @return QByteArray
+ */
+QByteArray ConversionCache::key(const QByteArray &input, Direction direction, const QByteArray &options)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(LIBRARY_VERSION);
+    hash.addData(direction == XmlToJsonDirection ? "xml>json" : "json>xml");
+    hash.addData(options);
+    hash.addData(input);
+
+    return hash.result().toHex();
+}
+
+
+/**
+ * Retrieves the output stored for the key passed. Returns true on hit, false otherwise.
+ *
+ * @param key: the entry key
+ * @param output: the stored output, set only on hit
+ *
+ * @return bool
+ */
+bool ConversionCache::find(const QByteArray &key, QByteArray &output)
+{
+    quint64 tick;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        QHash<QByteArray, Entry>::const_iterator it = m_entries.constFind(key);
+        if(it == m_entries.constEnd()){
+            m_misses++;
+            return false;
+        }
+
+        tick = it->tick;
+    }
+
+    // Read the entry without holding the lock, so that the lookups of other
+    // threads don't wait for the disk. Entries are replaced atomically, and the
+    // same key always stores the same output, so a concurrent insert is harmless.
+    QFile f(entryPath(key));
+    bool opened = f.open(QIODevice::ReadOnly);
+
+    if(opened){
+        output = f.readAll();
+
+        // Persist the access time, so that the eviction order survives restarts
+        f.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        f.close();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QByteArray, Entry>::iterator it = m_entries.find(key);
+
+    if(!opened){
+        // The entry has been removed from outside: forget it, unless it has been stored again meanwhile
+        if(it != m_entries.end() && it->tick == tick){
+            m_size -= it->size;
+            m_lru.remove(it->tick);
+            m_entries.erase(it);
+        }
+
+        m_misses++;
+        return false;
+    }
+
+    // The entry may have been evicted while reading it
+    if(it != m_entries.end()){
+        touch(key, *it);
+    }
+    m_hits++;
+
+    return true;
+}
+
+
+/**
+ * Stores the output for the key passed, evicting the least recently used entries if needed.
+ * Returns true if the output has been stored, false otherwise.
+ *
+ * @param key: the entry key
+ * @param output: the output to store
+ *
+ * @return bool
+ */
+bool ConversionCache::insert(const QByteArray &key, const QByteArray &output)
+{
+    qint64 size = output.size();
+
+    // Outputs bigger than the whole cache are never stored
+    if(size > m_maxSize){
+        return false;
+    }
+
+    // Write the entry atomically, so that a concurrent reader never sees a partial file.
+    // The lock is taken only to update the bookkeeping.
+    QSaveFile f(entryPath(key));
+    if(!f.open(QIODevice::WriteOnly) || f.write(output) != size || !f.commit()){
+        qWarning() << "Error while writing cache entry: " << entryPath(key);
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // Replace the previous entry, if any
+    QHash<QByteArray, Entry>::iterator it = m_entries.find(key);
+    if(it != m_entries.end()){
+        m_size -= it->size;
+        m_lru.remove(it->tick);
+        m_entries.erase(it);
+    }
+
+    evict(size);
+
+    Entry entry = {size, 0};
+    touch(key, entry);
+    m_entries.insert(key, entry);
+    m_size += size;
+
+    return true;
+}
+
+
+/**
+ * Removes all the cache entries
+ */
+void ConversionCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    foreach (const QByteArray &key, m_entries.keys()) {
+        QFile::remove(entryPath(key));
+    }
+
+    m_entries.clear();
+    m_lru.clear();
+    m_size = 0;
+}
+
+
+/**
+ * Returns the cache directory path
+ *
+ * @return QString
+ */
+QString ConversionCache::path() const
+{
+    return m_path;
+}
+
+
+/**
+ * Returns the size in bytes of the stored entries
+ *
+ * @return qint64
+ */
+qint64 ConversionCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+
+/**
+ * Returns the maximum size in bytes of the stored entries
+ *
+ * @return qint64
+ */
+qint64 ConversionCache::maxSize() const
+{
+    return m_maxSize;
+}
+
+
+/**
+ * Returns the number of cache hits
+ *
+ * @return quint64
+ */
+quint64 ConversionCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+
+/**
+ * Returns the number of cache misses
+ *
+ * @return quint64
+ */
+quint64 ConversionCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+
+/**
+ * Loads the entries already stored in the cache directory, ordered by
+ * their last access time
+ */
+void ConversionCache::load()
+{
+    QDir dir(m_path);
+    QFileInfoList files = dir.entryInfoList(QStringList() << "*.cache", QDir::Files, QDir::Time | QDir::Reversed);
+
+    foreach (const QFileInfo &info, files) {
+        Entry entry = {info.size(), 0};
+        QByteArray key = info.completeBaseName().toLatin1();
+
+        touch(key, entry);
+        m_entries.insert(key, entry);
+        m_size += entry.size;
+    }
+
+    // The maximum size may have been reduced since the last run
+    evict(0);
+}
+
+
+/**
+ * Removes the least recently used entries until the required bytes fit
+ *
+ * @param required: the bytes needed by the entry that is going to be stored
+ */
+void ConversionCache::evict(qint64 required)
+{
+    while(!m_lru.isEmpty() && m_size + required > m_maxSize){
+        QByteArray key = m_lru.take(m_lru.firstKey());
+
+        m_size -= m_entries.take(key).size;
+        QFile::remove(entryPath(key));
+    }
+}
+
+
+/**
+ * Marks the entry as the most recently used
+ *
+ * @param key: the entry key
+ * @param entry: the entry to update
+ */
+void ConversionCache::touch(const QByteArray &key, Entry &entry)
+{
+    m_lru.remove(entry.tick);
+
+    entry.tick = ++m_tick;
+    m_lru.insert(entry.tick, key);
+}
+
+
+/**
+ * Returns the path of the file storing the entry
+ *
+ * @param key: the entry key
+ *
+ * @return QString
+ */
+QString ConversionCache::entryPath(const QByteArray &key) const
+{
+    return m_path + "/" + QString::fromLatin1(key) + ".cache";
+}
+
+}
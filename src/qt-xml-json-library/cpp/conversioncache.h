@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERSIONCACHE_H
+#define CONVERSIONCACHE_H
+
+#include <QDebug>
+
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+
+
+namespace LTDev {
+
+class ConversionCache
+{
+public:
+    /**
+     * @brief Conversion direction, part of the cache key
+     */
+    enum Direction {
+        XmlToJsonDirection,
+        JsonToXmlDirection
+    };
+
+    /**
+     * @brief Constructor
+     */
+    ConversionCache(const QString &dirPath, qint64 maxSize = 256 * 1024 * 1024);
+
+    /**
+     * @brief Returns the cache key of the input passed
+     */
+    static QByteArray key(const QByteArray &input, Direction direction, const QByteArray &options = QByteArray());
+
+    /**
+     * @brief Retrieves the output stored for the key passed. Returns true on hit, false otherwise.
+     */
+    bool find(const QByteArray &key, QByteArray &output);
+
+    /**
+     * @brief Stores the output for the key passed, evicting the least recently used entries if needed
+     */
+    bool insert(const QByteArray &key, const QByteArray &output);
+
+    /**
+     * @brief Removes all the cache entries
+     */
+    void clear();
+
+    /**
+     * @brief Returns the cache directory path
+     */
+    QString path() const;
+
+    /**
+     * @brief Returns the size in bytes of the stored entries
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Returns the maximum size in bytes of the stored entries
+     */
+    qint64 maxSize() const;
+
+    /**
+     * @brief Returns the number of cache hits
+     */
+    quint64 hits() const;
+
+    /**
+     * @brief Returns the number of cache misses
+     */
+    quint64 misses() const;
+
+private:
+    /**
+     * @brief Cache entry bookkeeping
+     */
+    struct Entry {
+        qint64 size;
+        quint64 tick;
+    };
+
+    /**
+     * @brief Loads the entries already stored in the cache directory
+     */
+    void load();
+
+    /**
+     * @brief Removes the least recently used entries until the required bytes fit
+     */
+    void evict(qint64 required);
+
+    /**
+     * @brief Marks the entry as the most recently used
+     */
+    void touch(const QByteArray &key, Entry &entry);
+
+    /**
+     * @brief Returns the path of the file storing the entry
+     */
+    QString entryPath(const QByteArray &key) const;
+
+    QString m_path;
+    qint64 m_maxSize;
+    qint64 m_size;
+    quint64 m_tick;
+    quint64 m_hits;
+    quint64 m_misses;
+
+    // Key -> entry, and access tick -> key (least recently used first)
+    QHash<QByteArray, Entry> m_entries;
+    QMap<quint64, QByteArray> m_lru;
+
+    mutable QMutex m_mutex;
+};
+
+}
+
+#endif // CONVERSIONCACHE_H
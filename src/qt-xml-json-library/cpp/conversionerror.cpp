@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "conversionerror.h"
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ */
+ConversionError::ConversionError()
+    : code(NoError), line(0), column(0)
+{
+
+}
+
+
+/**
+ * Returns true if the conversion failed
+ *
+ * @return bool
+ */
+bool ConversionError::hasError() const
+{
+    return code != NoError;
+}
+
+
+/**
+ * Sets the error passed, if any. Errors are optional in the conversion
+ * methods, so a null error is ignored.
+ *
+ * @param error: the error to set, or nullptr
+ * @param code: the error code
+ * @param message: the error description
+ * @param line: the line of the input at which the error occurred
+ * @param column: the column of the input at which the error occurred
+ */
+void ConversionError::set(ConversionError *error, Code code, const QString &message, qint64 line, qint64 column)
+{
+    if(!error){
+        return;
+    }
+
+    error->code = code;
+    error->message = message;
+    error->line = line;
+    error->column = column;
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERSIONERROR_H
+#define CONVERSIONERROR_H
+
+#include <QString>
+
+
+namespace LTDev {
+
+struct ConversionError
+{
+    /**
+     * @brief Error codes
+     */
+    enum Code {
+        NoError,
+        FileNotFound,
+        FileOpenError,
+        ParseError,
+        InputTooLarge,
+        TooManyElements,
+        TooDeep,
+        TooManyAttributes,
+        TextTooLong,
+        OutputTooLarge,
+        WriteError,
+        Unsupported
+    };
+
+    /**
+     * @brief Constructor
+     */
+    ConversionError();
+
+    /**
+     * @brief Returns true if the conversion failed
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Sets the error passed, if any
+     */
+    static void set(ConversionError *error, Code code, const QString &message, qint64 line = 0, qint64 column = 0);
+
+    /**
+     * @brief Error code
+     */
+    Code code;
+
+    /**
+     * @brief Error description
+     */
+    QString message;
+
+    /**
+     * @brief Line of the input at which the error occurred, 0 if unknown
+     */
+    qint64 line;
+
+    /**
+     * @brief Column of the input at which the error occurred, 0 if unknown
+     */
+    qint64 column;
+};
+
+}
+
+#endif // CONVERSIONERROR_H
@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "conversionoptions.h"
+
+#include <QString>
+
+namespace LTDev {
+
+/**
+ * @brief Constructor. All the limits are disabled.
+ */
+ConversionLimits::ConversionLimits()
+    : maxInputBytes(0), maxElements(0), maxDepth(0), maxAttributes(0), maxTextLength(0), maxOutputBytes(0)
+{
+
+}
+
+
+/**
+ * Returns true if no limit is set
+ *
+ * @return bool
+ */
+bool ConversionLimits::isUnlimited() const
+{
+    return maxInputBytes <= 0 && maxElements <= 0 && maxDepth <= 0
+            && maxAttributes <= 0 && maxTextLength <= 0 && maxOutputBytes <= 0;
+}
+
+
+/**
+ * @brief Constructor
+ */
+ConversionOptions::ConversionOptions()
+{
+
+}
+
+
+/**
+ * Returns the serialized options, part of the cache keys. The limits are
+ * included even if they don't change the output: an input accepted under
+ * looser limits must not be returned to a caller enforcing stricter ones.
+ *
+ * @return QByteArray
+ */
+QByteArray ConversionOptions::id() const
+{
+    return QString("maxInputBytes=%1;maxElements=%2;maxDepth=%3;"
+                   "maxAttributes=%4;maxTextLength=%5;maxOutputBytes=%6;")
+            .arg(limits.maxInputBytes)
+            .arg(limits.maxElements)
+            .arg(limits.maxDepth)
+            .arg(limits.maxAttributes)
+            .arg(limits.maxTextLength)
+            .arg(limits.maxOutputBytes)
+            .toUtf8();
+}
+
+}
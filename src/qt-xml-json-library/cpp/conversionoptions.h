@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CONVERSIONOPTIONS_H
+#define CONVERSIONOPTIONS_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+
+namespace LTDev {
+
+struct ConversionLimits
+{
+    /**
+     * @brief Constructor. All the limits are disabled.
+     */
+    ConversionLimits();
+
+    /**
+     * @brief Returns true if no limit is set
+     */
+    bool isUnlimited() const;
+
+    /**
+     * @brief Maximum size of the input, in bytes. 0 means unlimited.
+     */
+    qint64 maxInputBytes;
+
+    /**
+     * @brief Maximum number of elements. 0 means unlimited.
+     */
+    qint64 maxElements;
+
+    /**
+     * @brief Maximum nesting depth of the elements. 0 means unlimited.
+     */
+    int maxDepth;
+
+    /**
+     * @brief Maximum number of attributes of an element. 0 means unlimited.
+     */
+    int maxAttributes;
+
+    /**
+     * @brief Maximum length of a text node, in characters. 0 means unlimited.
+     */
+    qint64 maxTextLength;
+
+    /**
+     * @brief Maximum estimated size of the compact json output, in bytes. 0 means unlimited.
+     */
+    qint64 maxOutputBytes;
+};
+
+struct ConversionOptions
+{
+    /**
+     * @brief Constructor
+     */
+    ConversionOptions();
+
+    /**
+     * @brief Returns the serialized options, part of the cache keys
+     */
+    QByteArray id() const;
+
+    /**
+     * @brief Limits enforced while parsing the input
+     */
+    ConversionLimits limits;
+};
+
+}
+
+#endif // CONVERSIONOPTIONS_H
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "countingdevice.h"
+
+namespace LTDev {
+
+/**
+ * @brief Constructor. Opens the device: the bytes are read from the current
+ * position of the wrapped device, which must be open for reading.
+ *
+ * @param input: the device to read from
+ */
+CountingDevice::CountingDevice(QIODevice *input) : m_input(input), m_count(0)
+{
+    open(QIODevice::ReadOnly);
+}
+
+
+/**
+ * Returns true: the wrapped device is read as a stream, from its current
+ * position, and can't be seeked through this device.
+ *
+ * @return bool
+ */
+bool CountingDevice::isSequential() const
+{
+    return true;
+}
+
+
+/**
+ * Returns the bytes read from the wrapped device. QXmlStreamReader reads its
+ * device in blocks, so the count may be ahead of the parsed token, by at most
+ * one block, but it never exceeds the size of the input.
+ *
+ * @return qint64
+ */
+qint64 CountingDevice::count() const
+{
+    return m_count;
+}
+
+
+/**
+ * Reads from the wrapped device, counting the bytes read
+ *
+ * @param data: the buffer to read into
+ * @param maxSize: the size of the buffer
+ *
+ * @return qint64
+ */
+qint64 CountingDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 read = m_input->read(data, maxSize);
+
+    if(read > 0){
+        m_count += read;
+    }
+
+    return read;
+}
+
+
+/**
+ * Fails: the device is read only
+ *
+ * @return qint64
+ */
+qint64 CountingDevice::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+}
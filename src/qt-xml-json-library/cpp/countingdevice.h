@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef COUNTINGDEVICE_H
+#define COUNTINGDEVICE_H
+
+#include <QIODevice>
+
+
+namespace LTDev {
+
+/**
+ * @brief Sequential read only device counting the bytes read from the wrapped device
+ */
+class CountingDevice : public QIODevice
+{
+public:
+    /**
+     * @brief Constructor. Opens the device.
+     */
+    explicit CountingDevice(QIODevice *input);
+
+    /**
+     * @brief Returns true: the wrapped device is read as a stream
+     */
+    bool isSequential() const override;
+
+    /**
+     * @brief Returns the bytes read from the wrapped device
+     */
+    qint64 count() const;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    QIODevice *m_input;
+    qint64 m_count;
+};
+
+}
+
+#endif // COUNTINGDEVICE_H
@@ -0,0 +1,406 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "jsonindex.h"
+
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
+
+namespace LTDev {
+
+namespace {
+
+// Index header, followed by the number of paths, the size of the names and the number of entries
+const QByteArray indexMagic = "#xmljson-index 2\n";
+const quint64 headerSize = quint64(indexMagic.size()) + 3 * 8;
+
+// Size of a path of the path table: name offset, name length, first entry, number of entries
+const quint64 pathSize = 4 * 8;
+
+// Size of an entry: offset and length of the element json
+const quint64 entrySize = 2 * 8;
+
+
+/**
+ * Compares the bytes of the paths passed, as JsonIndexWriter does when
+ * sorting them. Returns a negative value if the first path comes before the
+ * second one, 0 if they are equal, a positive value otherwise.
+ *
+ * @param path1: the first utf-8 path
+ * @param path2: the second utf-8 path
+ *
+ * @return int
+ */
+int comparePaths(const QByteArray &path1, const QByteArray &path2)
+{
+    int result = std::memcmp(path1.constData(), path2.constData(), size_t(qMin(path1.size(), path2.size())));
+
+    return result != 0 ? result : path1.size() - path2.size();
+}
+
+}
+
+/**
+ * @brief Constructor
+ */
+JsonIndex::JsonIndex()
+    : m_data(nullptr), m_index(nullptr), m_pathCount(0), m_namesSize(0), m_entryCount(0)
+{
+
+}
+
+
+/**
+ * @brief Destructor. Unmaps the json and index files.
+ */
+JsonIndex::~JsonIndex()
+{
+    close();
+}
+
+
+/**
+ * Returns the default path of the index of the json file passed
+ *
+ * @param jsonFilePath: the path of the json file
+ *
+ * @return QString
+ */
+QString JsonIndex::indexPath(const QString &jsonFilePath)
+{
+    return jsonFilePath + ".idx";
+}
+
+
+/**
+ * Maps the json and index files in memory: the index is not read in
+ * advance, a lookup binary searches the sorted path table and reads only the
+ * entry of the element, and the element is parsed from its byte range, so it
+ * reads only the pages it needs instead of the whole files. Returns true on
+ * success, false otherwise.
+ *
+ * @param jsonFilePath: the path of the json file
+ * @param indexFilePath: the path of the index file, the default one if empty
+ *
+ * @return bool
+ */
+bool JsonIndex::open(const QString &jsonFilePath, const QString &indexFilePath)
+{
+    close();
+
+    m_file.setFileName(jsonFilePath);
+    if(!m_file.open(QIODevice::ReadOnly)){
+        qWarning() << "Error while loading file: " << jsonFilePath;
+        return false;
+    }
+
+    if(m_file.size() > 0){
+        m_data = m_file.map(0, m_file.size());
+        if(!m_data){
+            qWarning() << "Error while mapping file: " << jsonFilePath;
+            close();
+            return false;
+        }
+    }
+
+    if(!load(indexFilePath.isEmpty() ? indexPath(jsonFilePath) : indexFilePath)){
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Unmaps the json and index files
+ */
+void JsonIndex::close()
+{
+    if(m_data){
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+
+    if(m_index){
+        m_indexFile.unmap(m_index);
+        m_index = nullptr;
+    }
+
+    m_file.close();
+    m_indexFile.close();
+    m_pathCount = 0;
+    m_namesSize = 0;
+    m_entryCount = 0;
+}
+
+
+/**
+ * Returns true if the json file is mapped
+ *
+ * @return bool
+ */
+bool JsonIndex::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+
+/**
+ * Returns the paths of the indexed elements, sorted by their utf-8 bytes
+ *
+ * @return QStringList
+ */
+QStringList JsonIndex::paths() const
+{
+    QStringList indexPaths;
+
+    for(quint64 i=0; i<m_pathCount; i++){
+        indexPaths.append(QString::fromUtf8(name(i)));
+    }
+
+    return indexPaths;
+}
+
+
+/**
+ * Returns the number of elements with the path passed
+ *
+ * @param path: the element path, as "/root/child"
+ *
+ * @return qint64
+ */
+qint64 JsonIndex::count(const QString &path) const
+{
+    quint64 first, count;
+
+    return find(path, first, count) ? qint64(count) : 0;
+}
+
+
+/**
+ * Returns the json of the element with the path and ordinal passed, empty if
+ * not indexed. The entry is checked against the size of the json file, so a
+ * stale or foreign index can't read out of the mapping. The data is not
+ * copied: it refers to the mapped file and is valid until the index is closed.
+ *
+ * @param path: the element path, as "/root/child"
+ * @param ordinal: the position of the element among the ones with the same path
+ *
+ * @return QByteArray
+ */
+QByteArray JsonIndex::slice(const QString &path, qint64 ordinal) const
+{
+    quint64 first, count;
+
+    if(!find(path, first, count) || ordinal < 0 || quint64(ordinal) >= count){
+        return QByteArray();
+    }
+
+    quint64 entry = headerSize + m_pathCount * pathSize + m_namesSize + (first + quint64(ordinal)) * entrySize;
+    quint64 offset = value(entry);
+    quint64 length = value(entry + 8);
+    quint64 size = quint64(m_file.size());
+
+    if(length == 0 || length > quint64(std::numeric_limits<int>::max()) || offset > size || length > size - offset){
+        qWarning() << "Malformed index: " << m_indexFile.fileName();
+        return QByteArray();
+    }
+
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(m_data + offset), int(length));
+}
+
+
+/**
+ * Returns the element with the path and ordinal passed, empty if not indexed
+ *
+ * @param path: the element path, as "/root/child"
+ * @param ordinal: the position of the element among the ones with the same path
+ *
+ * @return QJsonObject
+ */
+QJsonObject JsonIndex::element(const QString &path, qint64 ordinal) const
+{
+    QByteArray data = slice(path, ordinal);
+    if(data.isEmpty()){
+        return QJsonObject();
+    }
+
+    return QJsonDocument::fromJson(data).object();
+}
+
+
+/**
+ * Returns all the elements with the path passed, in document order
+ *
+ * @param path: the element path, as "/root/child"
+ *
+ * @return QList<QJsonObject>
+ */
+QList<QJsonObject> JsonIndex::elements(const QString &path) const
+{
+    QList<QJsonObject> jsonElements;
+    qint64 elementCount = count(path);
+
+    for(qint64 i=0; i<elementCount; i++){
+        jsonElements.append(element(path, i));
+    }
+
+    return jsonElements;
+}
+
+
+/**
+ * Maps the index file, written by JsonIndexWriter. Only the header is read:
+ * the sizes of the path table, of the names and of the entries must add up
+ * to the size of the file, and each path and entry is checked when read.
+ * Returns false if the index is malformed.
+ *
+ * @param indexFilePath: the path of the index file
+ *
+ * @return bool
+ */
+bool JsonIndex::load(const QString &indexFilePath)
+{
+    m_indexFile.setFileName(indexFilePath);
+    if(!m_indexFile.open(QIODevice::ReadOnly)){
+        qWarning() << "Error while loading file: " << indexFilePath;
+        return false;
+    }
+
+    quint64 size = quint64(m_indexFile.size());
+    m_index = size >= headerSize ? m_indexFile.map(0, m_indexFile.size()) : nullptr;
+
+    if(!m_index || std::memcmp(m_index, indexMagic.constData(), size_t(indexMagic.size())) != 0){
+        qWarning() << "Unsupported index: " << indexFilePath;
+        return false;
+    }
+
+    m_pathCount = value(quint64(indexMagic.size()));
+    m_namesSize = value(quint64(indexMagic.size()) + 8);
+    m_entryCount = value(quint64(indexMagic.size()) + 16);
+
+    quint64 available = size - headerSize;
+    bool ok = m_pathCount <= available / pathSize;
+    if(ok){
+        available -= m_pathCount * pathSize;
+        ok = m_namesSize <= available;
+    }
+    if(ok){
+        available -= m_namesSize;
+        ok = available % entrySize == 0 && m_entryCount == available / entrySize;
+    }
+
+    if(!ok){
+        qWarning() << "Malformed index: " << indexFilePath;
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Finds the entries of the path passed, by binary searching the path table.
+ * Returns false if the path is not indexed, or if its entries are out of the
+ * index.
+ *
+ * @param path: the element path, as "/root/child"
+ * @param first: set to the first entry of the path
+ * @param count: set to the number of entries of the path
+ *
+ * @return bool
+ */
+bool JsonIndex::find(const QString &path, quint64 &first, quint64 &count) const
+{
+    QByteArray key = path.toUtf8();
+    quint64 low = 0;
+    quint64 high = m_pathCount;
+
+    while(low < high){
+        quint64 middle = low + (high - low) / 2;
+        int result = comparePaths(name(middle), key);
+
+        if(result < 0){
+            low = middle + 1;
+        } else if(result > 0){
+            high = middle;
+        } else {
+            quint64 position = headerSize + middle * pathSize;
+            first = value(position + 16);
+            count = value(position + 24);
+
+            if(first > m_entryCount || count > m_entryCount - first){
+                qWarning() << "Malformed index: " << m_indexFile.fileName();
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * Returns the utf-8 name of the path at the position passed of the path
+ * table, empty if out of the names. The data refers to the mapped index.
+ *
+ * @param position: the position in the path table
+ *
+ * @return QByteArray
+ */
+QByteArray JsonIndex::name(quint64 position) const
+{
+    quint64 offset = value(headerSize + position * pathSize);
+    quint64 length = value(headerSize + position * pathSize + 8);
+
+    if(offset > m_namesSize || length > m_namesSize - offset || length > quint64(std::numeric_limits<int>::max())){
+        return QByteArray();
+    }
+
+    const uchar *names = m_index + headerSize + m_pathCount * pathSize;
+
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(names + offset), int(length));
+}
+
+
+/**
+ * Returns the 64 bit little endian integer at the offset passed of the index
+ * file
+ *
+ * @param offset: the offset in the index file
+ *
+ * @return quint64
+ */
+quint64 JsonIndex::value(quint64 offset) const
+{
+    return qFromLittleEndian<quint64>(m_index + offset);
+}
+
+}
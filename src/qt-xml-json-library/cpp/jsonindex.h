@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSONINDEX_H
+#define JSONINDEX_H
+
+#include <QDebug>
+
+#include <QFile>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+
+namespace LTDev {
+
+class JsonIndex
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    JsonIndex();
+
+    /**
+     * @brief Destructor. Unmaps the json and index files.
+     */
+    ~JsonIndex();
+
+    /**
+     * @brief Returns the default path of the index of the json file passed
+     */
+    static QString indexPath(const QString &jsonFilePath);
+
+    /**
+     * @brief Maps the json and index files. Returns true on success, false otherwise.
+     */
+    bool open(const QString &jsonFilePath, const QString &indexFilePath = QString());
+
+    /**
+     * @brief Unmaps the json and index files
+     */
+    void close();
+
+    /**
+     * @brief Returns true if the json file is mapped
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the paths of the indexed elements
+     */
+    QStringList paths() const;
+
+    /**
+     * @brief Returns the number of elements with the path passed
+     */
+    qint64 count(const QString &path) const;
+
+    /**
+     * @brief Returns the json of the element with the path and ordinal passed, empty if not indexed
+     */
+    QByteArray slice(const QString &path, qint64 ordinal) const;
+
+    /**
+     * @brief Returns the element with the path and ordinal passed, empty if not indexed
+     */
+    QJsonObject element(const QString &path, qint64 ordinal) const;
+
+    /**
+     * @brief Returns all the elements with the path passed
+     */
+    QList<QJsonObject> elements(const QString &path) const;
+
+private:
+    /**
+     * @brief Maps the index file. Returns false if it is malformed.
+     */
+    bool load(const QString &indexFilePath);
+
+    /**
+     * @brief Finds the entries of the path passed. Returns false if the path is not indexed.
+     */
+    bool find(const QString &path, quint64 &first, quint64 &count) const;
+
+    /**
+     * @brief Returns the utf-8 name of the path at the position passed of the path table
+     */
+    QByteArray name(quint64 position) const;
+
+    /**
+     * @brief Returns the 64 bit integer at the offset passed of the index file
+     */
+    quint64 value(quint64 offset) const;
+
+    QFile m_file;
+    uchar *m_data;
+
+    QFile m_indexFile;
+    uchar *m_index;
+    quint64 m_pathCount;
+    quint64 m_namesSize;
+    quint64 m_entryCount;
+};
+
+}
+
+#endif // JSONINDEX_H
@@ -0,0 +1,197 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "jsonindexwriter.h"
+
+#include <QDebug>
+#include <QList>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace LTDev {
+
+namespace {
+
+/**
+ * Appends the value passed, as 8 little endian bytes
+ *
+ * @param buffer: the buffer to append to
+ * @param value: the value to append
+ */
+void appendUInt64(QByteArray &buffer, quint64 value)
+{
+    uchar bytes[8];
+    qToLittleEndian(value, bytes);
+    buffer.append(reinterpret_cast<const char *>(bytes), 8);
+}
+
+
+/**
+ * Returns true if the first path comes before the second one, comparing
+ * their bytes as JsonIndex does when searching them
+ *
+ * @param path1: the first utf-8 path
+ * @param path2: the second utf-8 path
+ *
+ * @return bool
+ */
+bool pathLessThan(const QByteArray &path1, const QByteArray &path2)
+{
+    int result = std::memcmp(path1.constData(), path2.constData(), size_t(qMin(path1.size(), path2.size())));
+
+    return result < 0 || (result == 0 && path1.size() < path2.size());
+}
+
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param device: the open device to write to
+ */
+JsonIndexWriter::JsonIndexWriter(QIODevice *device)
+    : m_device(device), m_error(false), m_written(false)
+{
+
+}
+
+
+/**
+ * @brief Destructor. Writes the index if not written yet.
+ */
+JsonIndexWriter::~JsonIndexWriter()
+{
+    flush();
+}
+
+
+/**
+ * Adds the byte range of an element. The ordinal of an element counts the
+ * elements with the same path added before it, so elements with the same
+ * path must be added in document order.
+ *
+ * @param path: the path of the element, made of the tags from the root
+ * @param offset: the offset of the element json
+ * @param length: the length of the element json
+ */
+void JsonIndexWriter::add(const QString &path, qint64 offset, qint64 length)
+{
+    Entry entry = {offset, length};
+    m_entries[path.toUtf8()].append(entry);
+}
+
+
+/**
+ * Writes the index to the device, once all the elements are added: the
+ * entries of a path are known only at the end of the document, and are
+ * written next to each other so that a lookup doesn't read the others.
+ * All the integers are 64 bit little endian. The index is made of:
+ *
+ *  - the "#xmljson-index 2\n" header;
+ *  - the number of paths, the size of the path names and the number of entries;
+ *  - the path table, sorted by the utf-8 bytes of the paths so that they can
+ *    be binary searched: for each path, the offset and the length of its
+ *    name, its first entry and the number of its entries;
+ *  - the path names;
+ *  - the entries, grouped by path and sorted by ordinal: for each element,
+ *    the offset and the length of its json.
+ *
+ * Returns false on write error.
+ *
+ * @return bool
+ */
+bool JsonIndexWriter::flush()
+{
+    if(m_written || m_error){
+        return !m_error;
+    }
+
+    m_written = true;
+
+    QList<QByteArray> paths = m_entries.keys();
+    std::sort(paths.begin(), paths.end(), pathLessThan);
+
+    QByteArray table, names;
+    quint64 entryCount = 0;
+
+    foreach(const QByteArray &path, paths){
+        quint64 count = quint64(m_entries.value(path).size());
+
+        appendUInt64(table, quint64(names.size()));
+        appendUInt64(table, quint64(path.size()));
+        appendUInt64(table, entryCount);
+        appendUInt64(table, count);
+
+        names += path;
+        entryCount += count;
+    }
+
+    QByteArray buffer = "#xmljson-index 2\n";
+    appendUInt64(buffer, quint64(paths.size()));
+    appendUInt64(buffer, quint64(names.size()));
+    appendUInt64(buffer, entryCount);
+    buffer += table;
+    buffer += names;
+
+    foreach(const QByteArray &path, paths){
+        foreach(const Entry &entry, m_entries.value(path)){
+            appendUInt64(buffer, quint64(entry.offset));
+            appendUInt64(buffer, quint64(entry.length));
+
+            if(buffer.size() >= 64 * 1024 && !write(buffer)){
+                return false;
+            }
+        }
+    }
+
+    m_entries.clear();
+
+    return write(buffer);
+}
+
+
+/**
+ * Writes the buffer passed to the device and clears it. Returns false on
+ * write error.
+ *
+ * @param buffer: the bytes to write
+ *
+ * @return bool
+ */
+bool JsonIndexWriter::write(QByteArray &buffer)
+{
+    if(m_device->write(buffer) != buffer.size()){
+        qWarning() << "Error while writing index: " << m_device->errorString();
+        m_error = true;
+        return false;
+    }
+
+    buffer.resize(0);
+
+    return true;
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSONINDEXWRITER_H
+#define JSONINDEXWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+
+namespace LTDev {
+
+class JsonIndexWriter
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    JsonIndexWriter(QIODevice *device);
+
+    /**
+     * @brief Destructor. Writes the index if not written yet.
+     */
+    ~JsonIndexWriter();
+
+    /**
+     * @brief Adds the byte range of an element. Elements with the same path must be added in document order.
+     */
+    void add(const QString &path, qint64 offset, qint64 length);
+
+    /**
+     * @brief Writes the index to the device, once all the elements are added. Returns false on write error.
+     */
+    bool flush();
+
+private:
+    /**
+     * @brief Byte range of an element in the json file
+     */
+    struct Entry {
+        qint64 offset;
+        qint64 length;
+    };
+
+    /**
+     * @brief Writes the buffer passed to the device and clears it. Returns false on write error.
+     */
+    bool write(QByteArray &buffer);
+
+    QIODevice *m_device;
+    bool m_error;
+    bool m_written;
+
+    // Utf-8 path -> byte ranges, by ordinal
+    QHash<QByteArray, QVector<Entry>> m_entries;
+};
+
+}
+
+#endif // JSONINDEXWRITER_H
@@ -52,19 +52,37 @@ QJsonObject JsonToXml::parse(const QString &jsonFilePath)
     }
 
     QFile file(jsonFilePath);
-
-    QString lines;
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        QTextStream stream(&file);
-        while (!stream.atEnd())
-        {
-            lines.append(stream.readLine());
-        }
+    if(!file.open(QIODevice::ReadOnly)){
+        qWarning() << "Error while loading file: " << jsonFilePath;
+        return QJsonObject();
     }
+
+    QJsonObject jsonObj = parse(&file);
     file.close();
 
-    return QJsonDocument::fromJson(lines.toUtf8()).toVariant().toJsonObject();
+    return jsonObj;
+}
+
+
+/**
+ * Parses the Json data read from the device. Returns an empty object
+ * if the data is not a valid json object.
+ *
+ * @param device: the open device to read from
+ *
+ * @return QJsonObject
+ */
+QJsonObject JsonToXml::parse(QIODevice *device)
+{
+    QJsonParseError error;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(device->readAll(), &error);
+
+    if(error.error != QJsonParseError::NoError){
+        qWarning() << "Error while parsing json: " << error.errorString() << "at offset" << error.offset;
+        return QJsonObject();
+    }
+
+    return jsonDoc.object();
 }
 
 
@@ -108,13 +126,34 @@ QDomDocument JsonToXml::convert(const QJsonObject &jsonObj)
         rootObj = jsonObj;
     }
 
-    // Append root element
-    QDomElement root = addElement(doc, doc, rootObj);
+    // Append root element and its children
+    convert(doc, doc, rootObj);
+
+    return doc;
+}
+
+
+/**
+ * Updates the xml document and adds to the node the xml tree extracted from
+ * the json element passed. Returns the added element. The nodes are created
+ * directly in the document, so an element can be added to an existing
+ * document without converting it into a document of its own first.
+ *
+ * @param doc: the xml document
+ * @param node: the node to which the element extracted from json will be added
+ * @param jsonObj: the json element to convert
+ *
+ * @return QDomElement
+ */
+QDomElement JsonToXml::convert(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj)
+{
+    // Append element
+    QDomElement el = addElement(doc, node, jsonObj);
 
     // Append children elements
-    addElements(doc, root, rootObj);
+    addElements(doc, el, jsonObj);
 
-    return doc;
+    return el;
 }
 
 
@@ -131,7 +170,7 @@ QDomDocument JsonToXml::convert(const QJsonObject &jsonObj)
 QDomElement JsonToXml::addElement(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj){
     // Extract xml values from json
     QString tag = jsonObj.value("tag").toString();
-    QString text = jsonObj.value("text").toString();
+    QString text = textValue(jsonObj.value("text"));
     QJsonArray attributes = jsonObj.value("attributes").toArray();
 
     // Create element
@@ -149,7 +188,7 @@ QDomElement JsonToXml::addElement(QDomDocument &doc, QDomNode &node, const QJson
         QJsonObject attr = v.toObject();
 
         QString name = attr.value("key").toString();
-        QString value = attr.value("value").toString();
+        QString value = textValue(attr.value("value"));
         el.setAttribute(name, value);
     }
 
@@ -196,4 +235,27 @@ void JsonToXml::addDocumentInstruction(QDomDocument &doc, const QJsonObject &jso
 }
 
 
+/**
+ * Returns the xml text of the json value. Numbers and booleans, emitted by the
+ * typed schema converters, are converted back into their textual representation.
+ * Returns a null string if the value is missing.
+ *
+ * @param value: the json value
+ *
+ * @return QString
+ */
+QString JsonToXml::textValue(const QJsonValue &value){
+    switch (value.type()) {
+    case QJsonValue::String:
+        return value.toString();
+    case QJsonValue::Double:
+        return value.toVariant().toString();
+    case QJsonValue::Bool:
+        return value.toBool() ? "true" : "false";
+    default:
+        return QString();
+    }
+}
+
+
 }
@@ -54,6 +54,11 @@ public:
      */
     static QJsonObject parse(const QString &jsonFilePath);
 
+    /**
+     * @brief Parses the Json data read from the device
+     */
+    static QJsonObject parse(QIODevice *device);
+
     /**
      * @brief Converts the Json file passed into a QDomDocument
      */
@@ -64,7 +69,16 @@ public:
      */
     static QDomDocument convert(const QJsonObject &jsonObj);
 
+    /**
+     * @brief Updates the xml document and adds to the node the xml tree extracted from the json element passed.
+     * Returns the added element.
+     */
+    static QDomElement convert(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj);
+
 private:
+    // Converts the document instruction of the specialized conversions
+    friend class SchemaConverter;
+
     /**
      * @brief Updates the xml document and adds to the node the xml element extracted
      * from the json object. Returns the added element.
@@ -81,6 +95,11 @@ private:
      * @brief Adds to the document the instruction specified in the json
      */
     static void addDocumentInstruction(QDomDocument &doc, const QJsonObject &jsonInstruction);
+
+    /**
+     * @brief Returns the xml text of the json value, typed values included
+     */
+    static QString textValue(const QJsonValue &value);
 };
 }
 
@@ -0,0 +1,328 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "jsonwriter.h"
+
+#include <QDebug>
+
+namespace LTDev {
+
+namespace {
+// Pending output written to the device at once
+const int flushSize = 64 * 1024;
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param device: the open device to write to
+ * @param format: the output format, the same of QJsonDocument::toJson
+ */
+JsonWriter::JsonWriter(QIODevice *device, QJsonDocument::JsonFormat format)
+    : m_device(device), m_compact(format == QJsonDocument::Compact), m_error(false),
+      m_flushed(device->isSequential() ? 0 : device->pos()), m_keyWritten(false)
+{
+    m_buffer.reserve(flushSize + 4096);
+}
+
+
+/**
+ * @brief Destructor. Flushes the pending output.
+ */
+JsonWriter::~JsonWriter()
+{
+    flush();
+}
+
+
+/**
+ * Opens an object, as value of the current key or array item. Returns the
+ * offset of its opening brace.
+ *
+ * @return qint64
+ */
+qint64 JsonWriter::beginObject()
+{
+    return begin('{');
+}
+
+
+/**
+ * Closes the current object. Returns the offset following its closing brace:
+ * the bytes from the opening brace are the json of the object.
+ *
+ * @return qint64
+ */
+qint64 JsonWriter::endObject()
+{
+    return end('}');
+}
+
+
+/**
+ * Opens an array, as value of the current key or array item
+ */
+void JsonWriter::beginArray()
+{
+    begin('[');
+}
+
+
+/**
+ * Closes the current array
+ */
+void JsonWriter::endArray()
+{
+    end(']');
+}
+
+
+/**
+ * Writes the key of the next member of the current object. The members must be
+ * written in key order to produce the same output of QJsonDocument.
+ *
+ * @param key: the member key
+ */
+void JsonWriter::writeKey(const QString &key)
+{
+    if(m_filled.last()){
+        m_buffer += m_compact ? "," : ",\n";
+    }
+    m_filled.last() = true;
+
+    appendIndent();
+    appendString(key);
+    m_buffer += m_compact ? ":" : ": ";
+
+    m_keyWritten = true;
+}
+
+
+/**
+ * Writes a string value, as value of the current key or array item
+ *
+ * @param value: the value to write
+ */
+void JsonWriter::writeValue(const QString &value)
+{
+    beginValue();
+    appendString(value);
+}
+
+
+/**
+ * Writes a member with a string value in the current object
+ *
+ * @param key: the member key
+ * @param value: the member value
+ */
+void JsonWriter::writeMember(const QString &key, const QString &value)
+{
+    writeKey(key);
+    writeValue(value);
+}
+
+
+/**
+ * Writes the pending output to the device. Returns false on write error.
+ *
+ * @return bool
+ */
+bool JsonWriter::flush()
+{
+    if(m_buffer.isEmpty() || m_error){
+        return !m_error;
+    }
+
+    if(m_device->write(m_buffer) != m_buffer.size()){
+        qWarning() << "Error while writing json: " << m_device->errorString();
+        m_error = true;
+        return false;
+    }
+
+    m_flushed += m_buffer.size();
+    m_buffer.resize(0);
+
+    return true;
+}
+
+
+/**
+ * Returns the device position of the next byte written, pending output included.
+ * Positions of sequential devices are counted from construction.
+ *
+ * @return qint64
+ */
+qint64 JsonWriter::offset() const
+{
+    return m_flushed + m_buffer.size();
+}
+
+
+/**
+ * Returns true if writing to the device failed
+ *
+ * @return bool
+ */
+bool JsonWriter::hasError() const
+{
+    return m_error;
+}
+
+
+/**
+ * Writes the separator and the indentation preceding a value. Values of
+ * object members follow their key; array items are separated by commas and,
+ * in indented format, placed on their own line.
+ */
+void JsonWriter::beginValue()
+{
+    if(m_keyWritten || m_filled.isEmpty()){
+        m_keyWritten = false;
+        return;
+    }
+
+    if(m_filled.last()){
+        m_buffer += m_compact ? "," : ",\n";
+    }
+    m_filled.last() = true;
+
+    appendIndent();
+}
+
+
+/**
+ * Opens a container. Returns the offset of the opening bracket.
+ *
+ * @param bracket: the opening bracket
+ *
+ * @return qint64
+ */
+qint64 JsonWriter::begin(char bracket)
+{
+    beginValue();
+
+    qint64 start = offset();
+
+    m_buffer += bracket;
+    if(!m_compact){
+        m_buffer += '\n';
+    }
+
+    m_filled.append(false);
+
+    return start;
+}
+
+
+/**
+ * Closes the current container. In indented format an empty container is
+ * closed on the line following the opening bracket, as QJsonDocument does.
+ * Returns the offset following the closing bracket.
+ *
+ * @param bracket: the closing bracket
+ *
+ * @return qint64
+ */
+qint64 JsonWriter::end(char bracket)
+{
+    bool filled = m_filled.takeLast();
+
+    if(!m_compact && filled){
+        m_buffer += '\n';
+    }
+
+    appendIndent();
+    m_buffer += bracket;
+
+    qint64 stop = offset();
+
+    // The document ends with a new line in indented format
+    if(m_filled.isEmpty() && !m_compact){
+        m_buffer += '\n';
+    }
+
+    if(m_buffer.size() >= flushSize){
+        flush();
+    }
+
+    return stop;
+}
+
+
+/**
+ * Appends the string quoted and escaped. The string is encoded in UTF-8
+ * first: multi-byte sequences never contain ASCII bytes, so only the quote,
+ * the backslash and the control characters need escaping.
+ *
+ * @param string: the string to append
+ */
+void JsonWriter::appendString(const QString &string)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    const QByteArray utf8 = string.toUtf8();
+
+    m_buffer += '"';
+
+    for(char c : utf8){
+        uchar u = uchar(c);
+
+        if(u >= 0x20 && c != '"' && c != '\\'){
+            m_buffer += c;
+            continue;
+        }
+
+        m_buffer += '\\';
+
+        switch(c){
+        case '"': m_buffer += '"'; break;
+        case '\\': m_buffer += '\\'; break;
+        case '\b': m_buffer += 'b'; break;
+        case '\f': m_buffer += 'f'; break;
+        case '\n': m_buffer += 'n'; break;
+        case '\r': m_buffer += 'r'; break;
+        case '\t': m_buffer += 't'; break;
+        default:
+            m_buffer += "u00";
+            m_buffer += hex[u >> 4];
+            m_buffer += hex[u & 0xf];
+        }
+    }
+
+    m_buffer += '"';
+}
+
+
+/**
+ * Appends the indentation of the current depth, four spaces per level
+ */
+void JsonWriter::appendIndent()
+{
+    if(!m_compact){
+        m_buffer.append(4 * m_filled.size(), ' ');
+    }
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QString>
+#include <QVector>
+
+
+namespace LTDev {
+
+class JsonWriter
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    JsonWriter(QIODevice *device, QJsonDocument::JsonFormat format = QJsonDocument::Indented);
+
+    /**
+     * @brief Destructor. Flushes the pending output.
+     */
+    ~JsonWriter();
+
+    /**
+     * @brief Opens an object, as value of the current key or array item. Returns the offset of its opening brace.
+     */
+    qint64 beginObject();
+
+    /**
+     * @brief Closes the current object. Returns the offset following its closing brace.
+     */
+    qint64 endObject();
+
+    /**
+     * @brief Opens an array, as value of the current key or array item
+     */
+    void beginArray();
+
+    /**
+     * @brief Closes the current array
+     */
+    void endArray();
+
+    /**
+     * @brief Writes the key of the next member of the current object
+     */
+    void writeKey(const QString &key);
+
+    /**
+     * @brief Writes a string value, as value of the current key or array item
+     */
+    void writeValue(const QString &value);
+
+    /**
+     * @brief Writes a member with a string value in the current object
+     */
+    void writeMember(const QString &key, const QString &value);
+
+    /**
+     * @brief Writes the pending output to the device. Returns false on write error.
+     */
+    bool flush();
+
+    /**
+     * @brief Returns the device position of the next byte written, pending output included
+     */
+    qint64 offset() const;
+
+    /**
+     * @brief Returns true if writing to the device failed
+     */
+    bool hasError() const;
+
+private:
+    /**
+     * @brief Writes the separator and the indentation preceding a value
+     */
+    void beginValue();
+
+    /**
+     * @brief Opens a container
+     */
+    qint64 begin(char bracket);
+
+    /**
+     * @brief Closes the current container
+     */
+    qint64 end(char bracket);
+
+    /**
+     * @brief Appends the string quoted and escaped
+     */
+    void appendString(const QString &string);
+
+    /**
+     * @brief Appends the indentation of the current depth
+     */
+    void appendIndent();
+
+    QIODevice *m_device;
+    bool m_compact;
+    bool m_error;
+    qint64 m_flushed;
+    QByteArray m_buffer;
+
+    // Open containers: true once the container has a member or item
+    QVector<bool> m_filled;
+    bool m_keyWritten;
+};
+
+}
+
+#endif // JSONWRITER_H
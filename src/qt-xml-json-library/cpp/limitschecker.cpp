@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "limitschecker.h"
+
+namespace LTDev {
+
+/**
+ * @brief Constructor
+ *
+ * @param limits: the limits to enforce
+ */
+LimitsChecker::LimitsChecker(const ConversionLimits &limits)
+    : m_limits(limits), m_elements(0), m_textLength(0), m_outputBytes(0), m_depth(0)
+{
+
+}
+
+
+/**
+ * Checks the current token of the reader, to be called once after each
+ * readNext. The counts are incremental: the check fails at the first token
+ * exceeding a limit. The output size is estimated from the size of the
+ * compact json of each element and text, so the same input is rejected by
+ * both conversions, whatever the format of their output. Whitespace only
+ * texts are dropped by the parsed document and are not counted, unless they
+ * are CDATA sections.
+ *
+ * @param reader: the reader, positioned on the token to check
+ * @param inputBytes: the bytes read from the input so far
+ * @param error: the error set on failure, or nullptr
+ *
+ * @return bool
+ */
+bool LimitsChecker::check(const QXmlStreamReader &reader, qint64 inputBytes, ConversionError *error)
+{
+    if(m_limits.maxInputBytes > 0 && inputBytes > m_limits.maxInputBytes){
+        ConversionError::set(error, ConversionError::InputTooLarge,
+                             QString("Input exceeds %1 bytes").arg(m_limits.maxInputBytes),
+                             reader.lineNumber(), reader.columnNumber());
+        return false;
+    }
+
+    QXmlStreamReader::TokenType token = reader.tokenType();
+
+    if(token == QXmlStreamReader::StartElement){
+        m_elements++;
+        m_depth++;
+
+        QXmlStreamAttributes attributes = reader.attributes();
+
+        if(m_limits.maxElements > 0 && m_elements > m_limits.maxElements){
+            ConversionError::set(error, ConversionError::TooManyElements,
+                                 QString("Document exceeds %1 elements").arg(m_limits.maxElements),
+                                 reader.lineNumber(), reader.columnNumber());
+            return false;
+        }
+
+        if(m_limits.maxDepth > 0 && m_depth > m_limits.maxDepth){
+            ConversionError::set(error, ConversionError::TooDeep,
+                                 QString("Element nesting exceeds depth %1").arg(m_limits.maxDepth),
+                                 reader.lineNumber(), reader.columnNumber());
+            return false;
+        }
+
+        if(m_limits.maxAttributes > 0 && attributes.size() > m_limits.maxAttributes){
+            ConversionError::set(error, ConversionError::TooManyAttributes,
+                                 QString("Element %1 exceeds %2 attributes").arg(reader.qualifiedName().toString()).arg(m_limits.maxAttributes),
+                                 reader.lineNumber(), reader.columnNumber());
+            return false;
+        }
+
+        // {"attributes":[],"elements":[],"tag":""},
+        m_outputBytes += 42 + reader.qualifiedName().size();
+
+        foreach (const QXmlStreamAttribute &attr, attributes) {
+            // {"key":"","value":""},
+            m_outputBytes += 22 + attr.qualifiedName().size() + attr.value().size();
+        }
+    } else if(token == QXmlStreamReader::EndElement){
+        m_depth--;
+    }
+
+    // Consecutive character tokens belong to the same text node
+    if(token == QXmlStreamReader::Characters){
+        if(m_depth > 0 && (!reader.isWhitespace() || reader.isCDATA())){
+            m_textLength += reader.text().size();
+
+            // ,"text":""
+            m_outputBytes += reader.text().size() + (m_textLength == reader.text().size() ? 10 : 0);
+
+            if(m_limits.maxTextLength > 0 && m_textLength > m_limits.maxTextLength){
+                ConversionError::set(error, ConversionError::TextTooLong,
+                                     QString("Text exceeds %1 characters").arg(m_limits.maxTextLength),
+                                     reader.lineNumber(), reader.columnNumber());
+                return false;
+            }
+        }
+    } else {
+        m_textLength = 0;
+    }
+
+    if(m_limits.maxOutputBytes > 0 && m_outputBytes > m_limits.maxOutputBytes){
+        ConversionError::set(error, ConversionError::OutputTooLarge,
+                             QString("Estimated output exceeds %1 bytes").arg(m_limits.maxOutputBytes),
+                             reader.lineNumber(), reader.columnNumber());
+        return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LIMITSCHECKER_H
+#define LIMITSCHECKER_H
+
+#include <QXmlStreamReader>
+
+#include "conversionerror.h"
+#include "conversionoptions.h"
+
+
+namespace LTDev {
+
+/**
+ * @brief Enforces the conversion limits on the tokens of a QXmlStreamReader, for the limits scan of the
+ * DOM conversion and for the tokenizer of the pipelined one
+ */
+class LimitsChecker
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    explicit LimitsChecker(const ConversionLimits &limits);
+
+    /**
+     * @brief Checks the current token of the reader. Returns false, setting the error, if a limit is exceeded.
+     */
+    bool check(const QXmlStreamReader &reader, qint64 inputBytes, ConversionError *error);
+
+private:
+    ConversionLimits m_limits;
+
+    qint64 m_elements;
+    qint64 m_textLength;
+    qint64 m_outputBytes;
+    int m_depth;
+};
+
+}
+
+#endif // LIMITSCHECKER_H
@@ -0,0 +1,585 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pipelinedconverter.h"
+
+#include <QDomDocument>
+#include <QRegularExpression>
+#include <QScopedPointer>
+#include <QThread>
+#include <QVector>
+#include <QXmlStreamReader>
+
+#include <atomic>
+#include <functional>
+
+#include "countingdevice.h"
+#include "jsonindexwriter.h"
+#include "jsonwriter.h"
+#include "limitschecker.h"
+#include "spscqueue.h"
+
+namespace LTDev {
+
+namespace {
+
+// Tokens per batch, and batches or chunks queued between two stages
+const int batchSize = 512;
+const size_t queueSize = 16;
+
+/**
+ * @brief Waits for the other stage: spins first, then yields, then sleeps
+ */
+void backOff(int spins){
+    if(spins < 16){
+        return;
+    } else if(spins < 1024){
+        QThread::yieldCurrentThread();
+    } else {
+        QThread::usleep(50);
+    }
+}
+
+/**
+ * @brief Appends the value to the queue, waiting while it is full. Returns false if the pipeline is aborted.
+ */
+template <typename T>
+bool push(SpscQueue<T> &queue, T &&value, const std::atomic<bool> &aborted){
+    for(int spins = 0; !queue.tryPush(std::move(value)); spins++){
+        if(aborted.load(std::memory_order_relaxed)){
+            return false;
+        }
+        backOff(spins);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Takes the first value of the queue, waiting while it is empty. Returns false if the pipeline is aborted.
+ */
+template <typename T>
+bool pop(SpscQueue<T> &queue, T &value, const std::atomic<bool> &aborted){
+    for(int spins = 0; !queue.tryPop(value); spins++){
+        if(aborted.load(std::memory_order_relaxed)){
+            return false;
+        }
+        backOff(spins);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Thread running a pipeline stage
+ */
+class StageThread : public QThread
+{
+public:
+    StageThread(const std::function<void()> &stage) : m_stage(stage) {}
+
+protected:
+    void run() override
+    {
+        m_stage();
+    }
+
+private:
+    std::function<void()> m_stage;
+};
+
+/**
+ * @brief Write only device queueing the data written as chunks for the writer stage
+ */
+class ChunkDevice : public QIODevice
+{
+public:
+    ChunkDevice(SpscQueue<QByteArray> &chunks, const std::atomic<bool> &aborted)
+        : m_chunks(chunks), m_aborted(aborted)
+    {
+        open(QIODevice::WriteOnly);
+        setErrorString("Conversion aborted");
+    }
+
+    bool isSequential() const override
+    {
+        return true;
+    }
+
+protected:
+    qint64 readData(char *, qint64) override
+    {
+        return -1;
+    }
+
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        if(!push(m_chunks, QByteArray(data, int(len)), m_aborted)){
+            return -1;
+        }
+        return len;
+    }
+
+private:
+    SpscQueue<QByteArray> &m_chunks;
+    const std::atomic<bool> &m_aborted;
+};
+
+}
+
+/**
+ * @brief Token of the XML input. Whitespace only texts and the nodes that
+ * are not converted are dropped by the tokenizer.
+ */
+struct PipelinedConverter::Event
+{
+    enum Type {
+        Instruction,
+        StartElement,
+        EndElement,
+        Characters,
+        EndDocument,
+        Error
+    };
+
+    Event(Type type = EndDocument, const QString &name = QString(), const QString &text = QString(),
+          const QXmlStreamAttributes &attributes = QXmlStreamAttributes())
+        : type(type), name(name), text(text), attributes(attributes)
+    {
+    }
+
+    Type type;
+
+    // Element tag or instruction target
+    QString name;
+
+    // Text or instruction data
+    QString text;
+
+    QXmlStreamAttributes attributes;
+};
+
+/**
+ * @brief Queues and state shared by the stages. The errors are written by
+ * one stage each, and read after the Error event or after joining the stage.
+ */
+struct PipelinedConverter::Pipeline
+{
+    Pipeline() : events(queueSize), chunks(queueSize), aborted(false) {}
+
+    SpscQueue<QVector<Event>> events;
+    SpscQueue<QByteArray> chunks;
+    std::atomic<bool> aborted;
+
+    ConversionError tokenizerError;
+    ConversionError builderError;
+    ConversionError writerError;
+};
+
+/**
+ * Converts the XML read from the input into the json written to the output.
+ * The conversion runs as a pipeline of three stages on separate threads,
+ * connected by bounded lock-free queues: the tokenizer reads the XML tokens,
+ * the builder serializes the json of each element as soon as its tokens
+ * arrive, and the writer writes the json chunks to the output. The document
+ * is never built in memory, so the reading, the conversion and the writing
+ * of a single large file overlap.
+ *
+ * The json has the bytes written by XmlToJson::write for the parsed
+ * document, and so does the index: its offsets start from the position of
+ * the output. Schema converters are not used: the conversion fails with an
+ * Unsupported error if the root tag is one of the unsupported ones, which
+ * XmlJsonConverter::writeJsonPipelined sets to the registered schemas. The
+ * limits of the options are checked while tokenizing, with the estimates of
+ * the DOM conversion. On failure the output is incomplete, and the error, if
+ * passed, is set. The builder runs on the calling thread, the tokenizer and
+ * the writer on two other threads; the devices must not be used by other
+ * threads during the conversion.
+ *
+ * @param input: the open device to read the XML from
+ * @param output: the open device to write the json to
+ * @param options: the conversion options
+ * @param format: the output format
+ * @param index: the open device to write the index of the elements to, or nullptr
+ * @param error: the error set on failure, or nullptr
+ * @param unsupportedRootTags: the root tags rejected with an Unsupported error
+ *
+ * @return bool
+ */
+bool PipelinedConverter::convert(QIODevice *input, QIODevice *output, const ConversionOptions &options,
+                                 QJsonDocument::JsonFormat format, QIODevice *index, ConversionError *error,
+                                 const QStringList &unsupportedRootTags)
+{
+    Pipeline pipeline;
+
+    // Read before the writer stage starts moving it
+    qint64 offset = output->isSequential() ? 0 : output->pos();
+
+    StageThread tokenizer([&](){ tokenize(input, options.limits, unsupportedRootTags, pipeline); });
+    StageThread writer([&](){ write(pipeline, output); });
+
+    tokenizer.start();
+    writer.start();
+
+    build(pipeline, format, index, offset);
+
+    tokenizer.wait();
+    writer.wait();
+
+    const ConversionError &failure = pipeline.builderError.hasError() ? pipeline.builderError : pipeline.writerError;
+    if(failure.hasError()){
+        if(error){
+            *error = failure;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Reads the XML tokens and queues them in batches. The instruction is the
+ * XML declaration, rebuilt as QDomDocument reports it, or the processing
+ * instruction opening the document; it is queued before the root element.
+ * The limits are checked on each token by LimitsChecker, and an exceeded
+ * limit, an unsupported root tag or a malformed input ends the tokens with
+ * an Error event.
+ *
+ * @param input: the device to read from
+ * @param limits: the limits to enforce
+ * @param unsupportedRootTags: the root tags to reject
+ * @param pipeline: the pipeline
+ */
+void PipelinedConverter::tokenize(QIODevice *input, const ConversionLimits &limits,
+                                  const QStringList &unsupportedRootTags, Pipeline &pipeline)
+{
+    // QXmlStreamReader doesn't tell a standalone="no" declaration from a missing one
+    QRegularExpression standaloneRegExp("^\\x{FEFF}?\\s*<\\?xml[^>]*standalone\\s*=\\s*[\"'](yes|no)[\"']");
+    QRegularExpressionMatch standalone = standaloneRegExp.match(QString::fromUtf8(input->peek(256)));
+
+    // Count the bytes of the input, the character offset of the reader counts characters
+    CountingDevice device(input);
+    QXmlStreamReader reader(&device);
+    LimitsChecker checker(limits);
+
+    // Report xmlns declarations as attributes, as the parsed document does
+    reader.setNamespaceProcessing(false);
+
+    QVector<Event> batch;
+    batch.reserve(batchSize);
+
+    QString target, data;
+    bool instructionFound = false, rootFound = false;
+
+    int depth = 0;
+
+    ConversionError &error = pipeline.tokenizerError;
+
+    while(!reader.atEnd() && !error.hasError()){
+        QXmlStreamReader::TokenType token = reader.readNext();
+
+        if(!checker.check(reader, device.count(), &error)){
+            break;
+        }
+
+        switch(token){
+        case QXmlStreamReader::StartDocument:
+            if(!reader.documentVersion().isEmpty()){
+                target = "xml";
+                data = "version='" + reader.documentVersion().toString() + "'";
+
+                if(!reader.documentEncoding().isEmpty()){
+                    data += " encoding='" + reader.documentEncoding().toString() + "'";
+                }
+                if(standalone.hasMatch()){
+                    data += " standalone='" + standalone.captured(1) + "'";
+                }
+
+                instructionFound = true;
+            }
+            break;
+
+        case QXmlStreamReader::ProcessingInstruction:
+            if(!instructionFound && !rootFound){
+                target = reader.processingInstructionTarget().toString();
+                data = reader.processingInstructionData().toString();
+                instructionFound = true;
+            }
+            break;
+
+        case QXmlStreamReader::Comment:
+        case QXmlStreamReader::DTD:
+            // The document doesn't open with an instruction
+            instructionFound = true;
+            break;
+
+        case QXmlStreamReader::StartElement:
+            depth++;
+
+            if(!rootFound && unsupportedRootTags.contains(reader.qualifiedName().toString())){
+                ConversionError::set(&error, ConversionError::Unsupported,
+                                     QString("Schema converter of %1 is not supported by the pipelined conversion").arg(reader.qualifiedName().toString()),
+                                     reader.lineNumber(), reader.columnNumber());
+                break;
+            }
+
+            if(!rootFound){
+                batch.append(Event(Event::Instruction, target, data));
+                rootFound = true;
+            }
+
+            batch.append(Event(Event::StartElement, reader.qualifiedName().toString(), QString(), reader.attributes()));
+            break;
+
+        case QXmlStreamReader::EndElement:
+            depth--;
+            batch.append(Event(Event::EndElement));
+            break;
+
+        case QXmlStreamReader::Characters:
+            // Whitespace only texts are dropped by the parsed document, CDATA sections are kept
+            if(depth == 0 || (reader.isWhitespace() && !reader.isCDATA())){
+                break;
+            }
+
+            batch.append(Event(Event::Characters, QString(), reader.text().toString()));
+            break;
+
+        default:
+            break;
+        }
+
+        if(batch.size() >= batchSize){
+            if(!push(pipeline.events, std::move(batch), pipeline.aborted)){
+                return;
+            }
+
+            batch = QVector<Event>();
+            batch.reserve(batchSize);
+        }
+    }
+
+    if(!error.hasError() && reader.hasError()){
+        ConversionError::set(&error, ConversionError::ParseError, reader.errorString(),
+                             reader.lineNumber(), reader.columnNumber());
+    }
+
+    batch.append(Event(error.hasError() ? Event::Error : Event::EndDocument));
+    push(pipeline.events, std::move(batch), pipeline.aborted);
+}
+
+
+/**
+ * Builds the json of the tokens and queues it in chunks. Each element is
+ * written when its start token arrives, with the keys in the order of
+ * QJsonObject: the attributes and the children first, the tag and the text
+ * when the element ends, once it is known whether it has children. The
+ * attributes are written in the order of QDomNamedNodeMap, as XmlToJson::write
+ * does, so the json and the index have the same bytes. If an index device is
+ * passed, the byte range of each element is written into it, from the
+ * offset of the json in the output.
+ *
+ * @param pipeline: the pipeline
+ * @param format: the output format
+ * @param index: the device to write the index to, or nullptr
+ * @param offset: the position of the output when the json starts
+ */
+void PipelinedConverter::build(Pipeline &pipeline, QJsonDocument::JsonFormat format, QIODevice *index, qint64 offset)
+{
+    struct Frame {
+        QString tag;
+        QString path;
+        QString text;
+        qint64 start;
+        bool hasChildren;
+    };
+
+    ChunkDevice device(pipeline.chunks, pipeline.aborted);
+    JsonWriter writer(&device, format);
+    QScopedPointer<JsonIndexWriter> indexWriter(index ? new JsonIndexWriter(index) : nullptr);
+
+    QDomDocument attributesDoc;
+    QVector<Frame> stack;
+    QVector<Event> batch;
+    ConversionError &error = pipeline.builderError;
+    bool done = false;
+
+    while(!done && pop(pipeline.events, batch, pipeline.aborted)){
+        for(int i=0; i<batch.size() && !done; i++){
+            const Event &event = batch.at(i);
+
+            switch(event.type){
+            case Event::Instruction:
+                writer.beginObject();
+
+                writer.writeKey("instruction");
+                writer.beginObject();
+                writer.writeMember("data", event.text);
+                writer.writeMember("target", event.name);
+                writer.endObject();
+
+                writer.writeKey("root");
+                break;
+
+            case Event::StartElement: {
+                Frame frame;
+                frame.tag = event.name;
+                frame.hasChildren = false;
+
+                if(!stack.isEmpty()){
+                    // Children elements replace the text of the parent
+                    Frame &parent = stack.last();
+                    if(!parent.hasChildren){
+                        parent.hasChildren = true;
+                        parent.text.clear();
+                    }
+                }
+
+                if(indexWriter){
+                    frame.path = (stack.isEmpty() ? QString() : stack.last().path) + '/' + event.name;
+                }
+
+                frame.start = writer.beginObject();
+
+                writer.writeKey("attributes");
+                writer.beginArray();
+                if(event.attributes.size() > 1){
+                    // Set the attributes as the parser does, to write them in the order of the parsed document
+                    QDomElement element = attributesDoc.createElement(event.name);
+                    foreach (const QXmlStreamAttribute &attr, event.attributes) {
+                        element.setAttribute(attr.qualifiedName().toString(), attr.value().toString());
+                    }
+
+                    QDomNamedNodeMap attributes = element.attributes();
+                    for(int a=0; a<attributes.size(); a++){
+                        QDomAttr attr = attributes.item(a).toAttr();
+
+                        writer.beginObject();
+                        writer.writeMember("key", attr.name());
+                        writer.writeMember("value", attr.value());
+                        writer.endObject();
+                    }
+                } else {
+                    foreach (const QXmlStreamAttribute &attr, event.attributes) {
+                        writer.beginObject();
+                        writer.writeMember("key", attr.qualifiedName().toString());
+                        writer.writeMember("value", attr.value().toString());
+                        writer.endObject();
+                    }
+                }
+                writer.endArray();
+
+                writer.writeKey("elements");
+                writer.beginArray();
+
+                stack.append(frame);
+                break;
+            }
+
+            case Event::Characters:
+                if(!stack.last().hasChildren){
+                    stack.last().text += event.text;
+                }
+                break;
+
+            case Event::EndElement: {
+                Frame frame = stack.takeLast();
+
+                writer.endArray();
+                writer.writeMember("tag", frame.tag);
+
+                // The root text is not converted
+                if(!stack.isEmpty() && !frame.hasChildren){
+                    writer.writeMember("text", frame.text);
+                }
+
+                qint64 stop = writer.endObject();
+
+                if(indexWriter){
+                    indexWriter->add(frame.path, offset + frame.start, stop - frame.start);
+                }
+
+                // Close the document after the root element
+                if(stack.isEmpty()){
+                    writer.endObject();
+                }
+                break;
+            }
+
+            case Event::EndDocument:
+                done = true;
+                break;
+
+            case Event::Error:
+                error = pipeline.tokenizerError;
+                done = true;
+                break;
+            }
+        }
+
+        if(error.hasError() || writer.hasError()){
+            break;
+        }
+    }
+
+    if(done && !error.hasError() && indexWriter && !indexWriter->flush()){
+        ConversionError::set(&error, ConversionError::WriteError, "Error while writing index: " + index->errorString());
+    }
+
+    // Stop the other stages on failure, otherwise send the end of the json to the writer
+    if(!done || error.hasError() || !writer.flush()){
+        pipeline.aborted = true;
+        return;
+    }
+
+    push(pipeline.chunks, QByteArray(), pipeline.aborted);
+}
+
+
+/**
+ * Writes the json chunks to the output, until the empty chunk closing the json
+ *
+ * @param pipeline: the pipeline
+ * @param output: the device to write to
+ */
+void PipelinedConverter::write(Pipeline &pipeline, QIODevice *output)
+{
+    QByteArray chunk;
+
+    while(pop(pipeline.chunks, chunk, pipeline.aborted)){
+        if(chunk.isNull()){
+            return;
+        }
+
+        if(output->write(chunk) != chunk.size()){
+            ConversionError::set(&pipeline.writerError, ConversionError::WriteError,
+                                 "Error while writing json: " + output->errorString());
+            pipeline.aborted = true;
+            return;
+        }
+    }
+}
+
+}
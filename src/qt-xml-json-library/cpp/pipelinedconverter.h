@@ -0,0 +1,80 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PIPELINEDCONVERTER_H
+#define PIPELINEDCONVERTER_H
+
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QStringList>
+
+#include "conversionerror.h"
+#include "conversionoptions.h"
+
+
+namespace LTDev {
+
+class PipelinedConverter
+{
+public:
+    /**
+     * @brief Converts the XML read from the input into the json written to the output, tokenizing and
+     * writing on separate threads while building on the calling one. The documents whose root tag is one of the
+     * unsupported ones are rejected. Returns false on error.
+     */
+    static bool convert(QIODevice *input, QIODevice *output, const ConversionOptions &options = ConversionOptions(),
+                        QJsonDocument::JsonFormat format = QJsonDocument::Indented, QIODevice *index = nullptr,
+                        ConversionError *error = nullptr, const QStringList &unsupportedRootTags = QStringList());
+
+private:
+    /**
+     * @brief Token of the XML input
+     */
+    struct Event;
+
+    /**
+     * @brief Queues and state shared by the stages
+     */
+    struct Pipeline;
+
+    /**
+     * @brief First stage: reads the XML tokens and queues them in batches
+     */
+    static void tokenize(QIODevice *input, const ConversionLimits &limits, const QStringList &unsupportedRootTags,
+                         Pipeline &pipeline);
+
+    /**
+     * @brief Second stage: builds the json of the tokens and queues it in chunks
+     */
+    static void build(Pipeline &pipeline, QJsonDocument::JsonFormat format, QIODevice *index, qint64 offset);
+
+    /**
+     * @brief Third stage: writes the json chunks to the output
+     */
+    static void write(Pipeline &pipeline, QIODevice *output);
+};
+
+}
+
+#endif // PIPELINEDCONVERTER_H
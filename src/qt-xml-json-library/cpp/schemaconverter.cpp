@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "schemaconverter.h"
+
+namespace LTDev {
+
+/**
+ * @brief Destructor
+ */
+SchemaConverter::~SchemaConverter()
+{
+
+}
+
+
+/**
+ * Converts the XML document passed into a QJsonObject, using the specialized
+ * conversion of the root element. The result has the same structure of
+ * XmlToJson::convert.
+ *
+ * @param xmlDoc: the xml document to convert
+ *
+ * @return QJsonObject
+ */
+QJsonObject SchemaConverter::convert(const QDomDocument &xmlDoc) const
+{
+    QJsonObject jsonDoc;
+
+    // Insert xml document instruction
+    jsonDoc.insert("instruction", XmlToJson::processingInstruction(xmlDoc.firstChild()));
+
+    // Insert xml document root element
+    jsonDoc.insert("root", toJson(xmlDoc.documentElement()));
+
+    return jsonDoc;
+}
+
+
+/**
+ * Converts the Json object passed into a QDomDocument, using the specialized
+ * conversion of the root element. The json has the same structure accepted by
+ * JsonToXml::convert.
+ *
+ * @param jsonObj: the json to convert
+ *
+ * @return QDomDocument
+ */
+QDomDocument SchemaConverter::convert(const QJsonObject &jsonObj) const
+{
+    QDomDocument doc;
+
+    QJsonObject rootObj;
+
+    // Check if the json object is a document or an element
+    bool isDocument = jsonObj.contains("root") && jsonObj.contains("instruction");
+
+    if(isDocument){
+        // Add document instruction first
+        JsonToXml::addDocumentInstruction(doc, jsonObj.value("instruction").toObject());
+
+        // Retrieve document root
+        rootObj = jsonObj.value("root").toObject();
+    } else {
+        rootObj = jsonObj;
+    }
+
+    toXml(doc, doc, rootObj);
+
+    return doc;
+}
+
+}
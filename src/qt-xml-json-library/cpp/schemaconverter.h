@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SCHEMACONVERTER_H
+#define SCHEMACONVERTER_H
+
+#include "jsontoxml.h"
+#include "xmltojson.h"
+
+
+namespace LTDev {
+
+class SchemaConverter
+{
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~SchemaConverter();
+
+    /**
+     * @brief Returns the tag of the root element of the schema
+     */
+    virtual QString rootTag() const = 0;
+
+    /**
+     * @brief Returns the identifier of the converter, which changes with the generated output
+     */
+    virtual QString id() const = 0;
+
+    /**
+     * @brief Converts the root element passed into a QJsonObject
+     */
+    virtual QJsonObject toJson(const QDomElement &xmlElement) const = 0;
+
+    /**
+     * @brief Updates the xml document and adds to the node the root element extracted from the json object
+     */
+    virtual QDomElement toXml(QDomDocument &doc, QDomNode &node, const QJsonObject &jsonObj) const = 0;
+
+    /**
+     * @brief Converts the XML document passed into a QJsonObject
+     */
+    QJsonObject convert(const QDomDocument &xmlDoc) const;
+
+    /**
+     * @brief Converts the Json object passed into a QDomDocument
+     */
+    QDomDocument convert(const QJsonObject &jsonObj) const;
+};
+
+}
+
+#endif // SCHEMACONVERTER_H
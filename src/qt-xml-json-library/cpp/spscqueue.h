@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace LTDev {
+
+/**
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread.
+ * The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    explicit SpscQueue(size_t capacity)
+        : m_buffer(roundUp(capacity)), m_mask(m_buffer.size() - 1), m_head(0), m_tail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * @brief Appends the value, moving it, if the queue isn't full. Returns false, leaving the value untouched, otherwise.
+     * Producer thread only.
+     */
+    bool tryPush(T &&value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if(tail - m_head.load(std::memory_order_acquire) == m_buffer.size()){
+            return false;
+        }
+
+        m_buffer[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Takes the first value if the queue isn't empty. Returns false otherwise.
+     * Consumer thread only.
+     */
+    bool tryPop(T &value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+
+        if(head == m_tail.load(std::memory_order_acquire)){
+            return false;
+        }
+
+        // Release the slot content now, not when it is overwritten
+        value = std::move(m_buffer[head & m_mask]);
+        m_buffer[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the capacity of the queue
+     */
+    size_t capacity() const
+    {
+        return m_buffer.size();
+    }
+
+private:
+    static size_t roundUp(size_t capacity)
+    {
+        size_t size = 2;
+        while(size < capacity){
+            size <<= 1;
+        }
+        return size;
+    }
+
+    std::vector<T> m_buffer;
+    const size_t m_mask;
+
+    // Read position, written by the consumer, and write position, written by
+    // the producer: on separate cache lines so the threads don't share them
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+}
+
+#endif // SPSCQUEUE_H
@@ -24,6 +24,15 @@ SOFTWARE.
 
 #include "xmltojson.h"
 
+#include <QBuffer>
+#include <QScopedPointer>
+#include <QXmlStreamReader>
+
+#include <limits>
+
+#include "countingdevice.h"
+#include "limitschecker.h"
+
 namespace LTDev {
 
 /**
@@ -35,32 +44,34 @@ XmlToJson::XmlToJson()
 }
 
 /**
- * Parses the XML file
+ * Parses the XML file, enforcing the limits of the options. On failure
+ * the error, if passed, is set and an empty document is returned.
  *
  * @param xmlFilePath: the path of the file to parse
+ * @param options: the conversion options
+ * @param error: the error set on failure, or nullptr
  *
  * @return QDomDocument
  */
-QDomDocument XmlToJson::parse(const QString &xmlFilePath)
+QDomDocument XmlToJson::parse(const QString &xmlFilePath, const ConversionOptions &options, ConversionError *error)
 {
     // Check if file exists
     if(!QFile::exists(xmlFilePath)){
         qWarning() << "File not exists: "<< xmlFilePath;
+        ConversionError::set(error, ConversionError::FileNotFound, "File not exists: " + xmlFilePath);
         return QDomDocument();
     }
 
-    QDomDocument xmlDoc;
-
     // Load xml file as raw data
     QFile f(xmlFilePath);
     if (!f.open(QIODevice::ReadOnly ))
     {
         qWarning() << "Error while loading file: " << xmlFilePath;
+        ConversionError::set(error, ConversionError::FileOpenError, "Error while loading file: " + xmlFilePath);
         return QDomDocument();
     }
 
-    // Set data into the QDomDocument before processing
-    xmlDoc.setContent(&f);
+    QDomDocument xmlDoc = parse(&f, options, error);
     f.close();
 
     return xmlDoc;
@@ -68,15 +79,94 @@ QDomDocument XmlToJson::parse(const QString &xmlFilePath)
 
 
 /**
- * Converts the XML file passed into a QJsonObject
+ * Parses the XML data read from the device, enforcing the limits of the options.
+ * When a limit is set, the data is scanned before building the document, so a
+ * hostile input is rejected without allocating its whole tree. On failure the
+ * error, if passed, is set and an empty document is returned.
+ *
+ * @param device: the open device to read from
+ * @param options: the conversion options
+ * @param error: the error set on failure, or nullptr
+ *
+ * @return QDomDocument
+ */
+QDomDocument XmlToJson::parse(QIODevice *device, const ConversionOptions &options, ConversionError *error)
+{
+    const ConversionLimits &limits = options.limits;
+
+    QBuffer buffer;
+    QIODevice *input = device;
+
+    if(!limits.isUnlimited()){
+        // Sequential devices can't be read twice: buffer them, reading at most one byte over the limit
+        if(device->isSequential()){
+            qint64 maxSize = limits.maxInputBytes > 0 ? limits.maxInputBytes + 1 : std::numeric_limits<qint64>::max();
+            QByteArray data;
+
+            while(data.size() < maxSize){
+                QByteArray chunk = device->read(qMin<qint64>(maxSize - data.size(), 64 * 1024));
+                if(chunk.isEmpty() && !device->waitForReadyRead(-1)){
+                    break;
+                }
+                data.append(chunk);
+            }
+
+            buffer.setData(data);
+            buffer.open(QIODevice::ReadOnly);
+            input = &buffer;
+        }
+
+        if(limits.maxInputBytes > 0 && input->size() - input->pos() > limits.maxInputBytes){
+            ConversionError::set(error, ConversionError::InputTooLarge,
+                                 QString("Input exceeds %1 bytes").arg(limits.maxInputBytes));
+            return QDomDocument();
+        }
+
+        qint64 start = input->pos();
+
+        if(!checkLimits(input, limits, error)){
+            return QDomDocument();
+        }
+
+        input->seek(start);
+    }
+
+    QDomDocument xmlDoc;
+    QString errorMsg;
+    int line = 0, column = 0;
+
+    // Set data into the QDomDocument before processing
+    if(!xmlDoc.setContent(input, &errorMsg, &line, &column)){
+        ConversionError::set(error, ConversionError::ParseError, errorMsg, line, column);
+        return QDomDocument();
+    }
+
+    return xmlDoc;
+}
+
+
+/**
+ * Converts the XML file passed into a QJsonObject. On failure the error,
+ * if passed, is set and an empty object is returned.
  *
  * @param xmlFilePath: the path of the file to convert
+ * @param options: the conversion options
+ * @param error: the error set on failure, or nullptr
  *
  * @return QJsonObject
  */
-QJsonObject XmlToJson::convert(const QString &xmlFilePath)
+QJsonObject XmlToJson::convert(const QString &xmlFilePath, const ConversionOptions &options, ConversionError *error)
 {
-    QDomDocument doc = parse(xmlFilePath);
+    ConversionError parseError;
+
+    QDomDocument doc = parse(xmlFilePath, options, &parseError);
+    if(parseError.hasError()){
+        if(error){
+            *error = parseError;
+        }
+        return QJsonObject();
+    }
+
     return convert(doc);
 }
 
@@ -121,6 +211,210 @@ QJsonObject XmlToJson::convert(const QDomElement &xmlElement)
     };
 }
 
+/**
+ * Writes the json of the XML document to the device, as QJsonDocument::toJson
+ * would write the converted object, without building it in memory: the
+ * elements are serialized while walking the document and the output is
+ * written in chunks. If an index device is passed, the path, ordinal and
+ * byte range of each element are written into it (see JsonIndex).
+ *
+ * @param xmlDoc: the xml document to convert
+ * @param device: the open device to write to
+ * @param format: the output format
+ * @param index: the open device to write the index to, or nullptr
+ *
+ * @return bool
+ */
+bool XmlToJson::write(const QDomDocument &xmlDoc, QIODevice *device, QJsonDocument::JsonFormat format, QIODevice *index)
+{
+    JsonWriter writer(device, format);
+    QScopedPointer<JsonIndexWriter> indexWriter(index ? new JsonIndexWriter(index) : nullptr);
+    QDomNode instruction = xmlDoc.firstChild();
+
+    writer.beginObject();
+
+    // Keys are written in the sorted order of QJsonObject
+    writer.writeKey("instruction");
+    writer.beginObject();
+    if(instruction.isProcessingInstruction()){
+        writer.writeMember("data", instruction.toProcessingInstruction().data());
+        writer.writeMember("target", instruction.toProcessingInstruction().target());
+    } else {
+        writer.writeMember("data", "");
+        writer.writeMember("target", "");
+    }
+    writer.endObject();
+
+    writer.writeKey("root");
+    writeElement(writer, xmlDoc.documentElement(), false, QString(), indexWriter.data());
+
+    writer.endObject();
+
+    if(indexWriter && !indexWriter->flush()){
+        return false;
+    }
+
+    return writer.flush();
+}
+
+
+/**
+ * Writes the json object of the element, with the same members of the
+ * converted one: the text is written only for children elements without
+ * children. The element is added to the index once closed, when its byte
+ * range is known.
+ *
+ * @param writer: the json writer
+ * @param xmlElement: the element to write
+ * @param hasText: true if the text of the element is written (children elements only)
+ * @param parentPath: the path of the parent element, empty for the root
+ * @param index: the index writer, or nullptr
+ */
+void XmlToJson::writeElement(JsonWriter &writer, const QDomElement &xmlElement, bool hasText,
+                             const QString &parentPath, JsonIndexWriter *index){
+    QString path = index ? parentPath + '/' + xmlElement.tagName() : QString();
+
+    qint64 start = writer.beginObject();
+
+    writer.writeKey("attributes");
+    writer.beginArray();
+
+    QDomNamedNodeMap attributes = xmlElement.attributes();
+    for(int i=0; i<attributes.size(); i++){
+        QDomNode n = attributes.item(i);
+
+        if(!n.isNull()){
+            QDomAttr attr = xmlElement.attributeNode(n.nodeName());
+
+            writer.beginObject();
+            writer.writeMember("key", attr.name());
+            writer.writeMember("value", attr.value());
+            writer.endObject();
+        }
+    }
+    writer.endArray();
+
+    writer.writeKey("elements");
+    writer.beginArray();
+    for(QDomElement e=xmlElement.firstChild().toElement(); !e.isNull(); e = e.nextSibling().toElement()){
+        writeElement(writer, e, true, path, index);
+    }
+    writer.endArray();
+
+    writer.writeMember("tag", xmlElement.tagName());
+
+    if(hasText && xmlElement.firstChild().toElement().isNull()){
+        writer.writeMember("text", xmlElement.text());
+    }
+
+    qint64 stop = writer.endObject();
+
+    if(index){
+        index->add(path, start, stop - start);
+    }
+}
+
+
+/**
+ * Scans the XML data read from the device, enforcing the limits incrementally
+ * with LimitsChecker: the scan stops at the first token exceeding a limit. The
+ * input size is the count of the bytes read from the device. Returns false if
+ * a limit is exceeded or the data is malformed, setting the error.
+ *
+ * @param device: the device to read from
+ * @param limits: the limits to enforce
+ * @param error: the error set on failure, or nullptr
+ *
+ * @return bool
+ */
+bool XmlToJson::checkLimits(QIODevice *device, const ConversionLimits &limits, ConversionError *error){
+    // Count the bytes of the input, the character offset of the reader counts characters
+    CountingDevice input(device);
+    QXmlStreamReader reader(&input);
+    LimitsChecker checker(limits);
+
+    // Report xmlns declarations as attributes, as the parsed document does
+    reader.setNamespaceProcessing(false);
+
+    while(!reader.atEnd()){
+        reader.readNext();
+
+        if(!checker.check(reader, input.count(), error)){
+            return false;
+        }
+    }
+
+    if(reader.hasError()){
+        ConversionError::set(error, ConversionError::ParseError, reader.errorString(),
+                             reader.lineNumber(), reader.columnNumber());
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Updates the json previously converted from an XML document. The previous and
+ * the new documents are walked in lockstep: unchanged subtrees are kept from the
+ * previous json (no conversion and no copy), while the changed ones are reconverted
+ * and spliced into it. If a patch is passed, the JSON Patch (RFC 6902) operations
+ * turning the previous json into the returned one are appended to it.
+ *
+ * @param prevXmlDoc: the xml document from which the previous json was converted
+ * @param prevJsonObj: the previous json
+ * @param xmlDoc: the new xml document
+ * @param patch: the array to which the patch operations are appended, or nullptr
+ *
+ * @return QJsonObject
+ */
+QJsonObject XmlToJson::update(const QDomDocument &prevXmlDoc, const QJsonObject &prevJsonObj,
+                              const QDomDocument &xmlDoc, QJsonArray *patch)
+{
+    QJsonObject jsonDoc = prevJsonObj;
+    int patchSize = patch ? patch->size() : 0;
+
+    // Update xml document instruction
+    QJsonObject instruction = processingInstruction(xmlDoc.firstChild());
+    if(instruction != prevJsonObj.value("instruction").toObject()){
+        jsonDoc.insert("instruction", instruction);
+        addPatchOperation(patch, "replace", "/instruction", instruction);
+    }
+
+    QDomElement prevRoot = prevXmlDoc.documentElement();
+    QDomElement root = xmlDoc.documentElement();
+
+    // Update xml document root element
+    if(prevRoot.tagName() != root.tagName()){
+        QJsonObject jsonRoot = convert(root);
+        jsonDoc.insert("root", jsonRoot);
+        addPatchOperation(patch, "replace", "/root", jsonRoot);
+    } else {
+        QJsonObject jsonRoot = prevJsonObj.value("root").toObject();
+        bool mismatch = false;
+
+        if(updateElement(prevRoot, root, jsonRoot, "/root", false, patch, mismatch)){
+            jsonDoc.insert("root", jsonRoot);
+        }
+
+        // The previous json wasn't converted from the previous document: splicing into
+        // it would give a wrong result, so the whole document is converted again
+        if(mismatch){
+            qWarning() << "Previous json doesn't match the previous document, converting the whole document";
+
+            while(patch && patch->size() > patchSize){
+                patch->removeLast();
+            }
+
+            jsonDoc = convert(xmlDoc);
+            addPatchOperation(patch, "replace", "", jsonDoc);
+        }
+    }
+
+    return jsonDoc;
+}
+
+
 /**
  * Returns the array of the element's attributes
  *
@@ -162,32 +456,221 @@ QJsonArray XmlToJson::elements(QDomElement xmlElement){
     QJsonArray jsonElements;
 
     for(QDomElement e=xmlElement.firstChild().toElement(); !e.isNull(); e = e.nextSibling().toElement()){
-        QJsonArray jsonAttributes = attributes(e);
+        // Append element
+        jsonElements.append(element(e));
+    }
+
+    return jsonElements;
+
+}
+
+/**
+ * Returns the json object of a child element. Differently from the root element,
+ * children elements without children have their text inserted.
+ *
+ * @param xmlElement: the element to parse
+ *
+ * @return QJsonObject
+ */
+QJsonObject XmlToJson::element(const QDomElement &xmlElement){
+    QJsonArray jsonAttributes = attributes(xmlElement);
+
+    QJsonObject jsonElement = {
+        {"tag", xmlElement.tagName()},
+        {"attributes", jsonAttributes},
+
+    };
+
+    // Insert text if the current element hasn't children
+    if(xmlElement.firstChild().toElement().isNull()){
+        jsonElement.insert("text", xmlElement.text());
+    }
+
+
+    // Recursively parse children elements
+    QJsonArray childElements = elements(xmlElement);
+
+    // Insert children elements to the current element
+    jsonElement.insert("elements", childElements);
+
+    return jsonElement;
+}
+
+/**
+ * Updates the json object of an element having the same tag of the previous one.
+ * Attributes and text are replaced only if they changed, children with the same
+ * tag at the same position are updated recursively, the others are reconverted.
+ * If the json object doesn't have the tag and the children of the previous
+ * element, mismatch is set and the update stops. Returns true if the json
+ * object changed.
+ *
+ * @param prevXmlElement: the element from which the previous json object was converted
+ * @param xmlElement: the new element
+ * @param jsonObj: the previous json object, updated in place
+ * @param path: the JSON Pointer of the json object in the document
+ * @param hasText: true if the text of the element is converted (children elements only)
+ * @param patch: the array to which the patch operations are appended, or nullptr
+ * @param mismatch: set to true if the json object wasn't converted from the previous element
+ *
+ * @return bool
+ */
+bool XmlToJson::updateElement(const QDomElement &prevXmlElement, const QDomElement &xmlElement,
+                              QJsonObject &jsonObj, const QString &path, bool hasText, QJsonArray *patch,
+                              bool &mismatch){
+    QJsonArray jsonElements = jsonObj.value("elements").toArray();
+    int prevSize = jsonElements.size();
+
+    // Check that the json object has been converted from the previous element
+    int prevChildren = 0;
+    for(QDomElement e=prevXmlElement.firstChild().toElement(); !e.isNull(); e = e.nextSibling().toElement()){
+        prevChildren++;
+    }
 
-        QJsonObject jsonElement = {
-            {"tag", e.tagName()},
-            {"attributes", jsonAttributes},
+    if(jsonObj.value("tag").toString() != prevXmlElement.tagName() || prevChildren != prevSize){
+        mismatch = true;
+        return false;
+    }
+
+    bool changed = false;
 
-        };
+    // Update attributes
+    if(!sameAttributes(prevXmlElement, xmlElement)){
+        QJsonArray jsonAttributes = attributes(xmlElement);
+        jsonObj.insert("attributes", jsonAttributes);
+        addPatchOperation(patch, "replace", path + "/attributes", jsonAttributes);
+        changed = true;
+    }
 
-        // Insert text if the current element hasn't children
-        if(e.firstChild().toElement().isNull()){
-            jsonElement.insert("text", e.text());
+    // Update text, present only if the current element hasn't children
+    if(hasText){
+        bool hadText = jsonObj.contains("text");
+
+        if(xmlElement.firstChild().toElement().isNull()){
+            QString text = xmlElement.text();
+
+            if(!hadText || jsonObj.value("text").toString() != text){
+                jsonObj.insert("text", text);
+                addPatchOperation(patch, hadText ? "replace" : "add", path + "/text", text);
+                changed = true;
+            }
+        } else if(hadText){
+            jsonObj.remove("text");
+            addPatchOperation(patch, "remove", path + "/text");
+            changed = true;
         }
+    }
 
+    // Update children elements
+    bool elementsChanged = false;
 
-        // Recursively parse children elements
-        QJsonArray childElements = elements(e);
+    QDomElement prevChild = prevXmlElement.firstChild().toElement();
+    QDomElement child = xmlElement.firstChild().toElement();
+    int i = 0;
 
-        // Insert children elements to the current element
-        jsonElement.insert("elements", childElements);
+    for(; !child.isNull(); child = child.nextSibling().toElement(), i++){
+        QString childPath = path + "/elements/" + QString::number(i);
 
-        // Append element
-        jsonElements.append(jsonElement);
+        if(i >= prevSize){
+            // New element
+            QJsonObject jsonChild = element(child);
+            jsonElements.append(jsonChild);
+            addPatchOperation(patch, "add", childPath, jsonChild);
+            elementsChanged = true;
+            continue;
+        }
+
+        QJsonObject jsonChild = jsonElements.at(i).toObject();
+        bool childChanged = true;
+
+        if(prevChild.tagName() == child.tagName()){
+            childChanged = updateElement(prevChild, child, jsonChild, childPath, true, patch, mismatch);
+
+            if(mismatch){
+                return false;
+            }
+        } else {
+            jsonChild = element(child);
+            addPatchOperation(patch, "replace", childPath, jsonChild);
+        }
+
+        // Splice only the changed subtrees
+        if(childChanged){
+            jsonElements.replace(i, jsonChild);
+            elementsChanged = true;
+        }
+
+        prevChild = prevChild.nextSibling().toElement();
     }
 
-    return jsonElements;
+    // Remove the elements no longer present, starting from the last one so that
+    // the patch operations can be applied in sequence
+    for(int j = prevSize - 1; j >= i; j--){
+        jsonElements.removeAt(j);
+        addPatchOperation(patch, "remove", path + "/elements/" + QString::number(j));
+        elementsChanged = true;
+    }
+
+    if(elementsChanged){
+        jsonObj.insert("elements", jsonElements);
+        changed = true;
+    }
+
+    return changed;
+}
+
+
+/**
+ * Returns true if the elements have the same attributes, regardless of their order
+ *
+ * @param xmlElement: the first element
+ * @param otherXmlElement: the second element
+ *
+ * @return bool
+ */
+bool XmlToJson::sameAttributes(const QDomElement &xmlElement, const QDomElement &otherXmlElement){
+    QDomNamedNodeMap attributes = xmlElement.attributes();
+    QDomNamedNodeMap otherAttributes = otherXmlElement.attributes();
+
+    if(attributes.size() != otherAttributes.size()){
+        return false;
+    }
+
+    for(int i=0; i<attributes.size(); i++){
+        QDomAttr attr = attributes.item(i).toAttr();
+
+        if(!otherXmlElement.hasAttribute(attr.name())
+                || otherXmlElement.attribute(attr.name()) != attr.value()){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Appends a JSON Patch (RFC 6902) operation to the patch, if any
+ *
+ * @param patch: the array to which the operation is appended, or nullptr
+ * @param op: the operation name (add, remove, replace)
+ * @param path: the JSON Pointer of the target location
+ * @param value: the operation value, undefined for remove operations
+ */
+void XmlToJson::addPatchOperation(QJsonArray *patch, const QString &op, const QString &path, const QJsonValue &value){
+    if(!patch){
+        return;
+    }
+
+    QJsonObject operation = {
+        {"op", op},
+        {"path", path}
+    };
+
+    if(!value.isUndefined()){
+        operation.insert("value", value);
+    }
 
+    patch->append(operation);
 }
 
 /**
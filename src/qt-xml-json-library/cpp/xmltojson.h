@@ -28,6 +28,7 @@ SOFTWARE.
 
 #include <QFile>
 #include <QDebug>
+#include <QIODevice>
 
 #include <QDomElement>
 #include <QDomDocument>
@@ -35,6 +36,12 @@ SOFTWARE.
 
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QJsonDocument>
+
+#include "conversionerror.h"
+#include "conversionoptions.h"
+#include "jsonindexwriter.h"
+#include "jsonwriter.h"
 
 
 namespace LTDev {
@@ -48,14 +55,22 @@ public:
     XmlToJson();
 
     /**
-     * @brief Parses the XML file
+     * @brief Parses the XML file, enforcing the limits of the options
+     */
+    static QDomDocument parse(const QString& xmlFilePath, const ConversionOptions &options = ConversionOptions(),
+                              ConversionError *error = nullptr);
+
+    /**
+     * @brief Parses the XML data read from the device, enforcing the limits of the options
      */
-    static QDomDocument parse(const QString& xmlFilePath);
+    static QDomDocument parse(QIODevice *device, const ConversionOptions &options = ConversionOptions(),
+                              ConversionError *error = nullptr);
 
     /**
      * @brief Converts the XML file passed into a QJsonObject
      */
-    static QJsonObject convert(const QString& xmlFilePath);
+    static QJsonObject convert(const QString& xmlFilePath, const ConversionOptions &options = ConversionOptions(),
+                               ConversionError *error = nullptr);
 
     /**
      * @brief Converts the XML document passed into a QJsonObject
@@ -67,8 +82,30 @@ public:
      */
     static QJsonObject convert(const QDomElement& xmlElement);
 
+    /**
+     * @brief Writes the json of the XML document to the device, without building it in memory.
+     * If an index device is passed, the byte range of each element is written into it.
+     * Returns false on write error.
+     */
+    static bool write(const QDomDocument& xmlDoc, QIODevice *device,
+                      QJsonDocument::JsonFormat format = QJsonDocument::Indented, QIODevice *index = nullptr);
+
+    /**
+     * @brief Updates the json previously converted from an XML document, reconverting only the changed subtrees
+     */
+    static QJsonObject update(const QDomDocument& prevXmlDoc, const QJsonObject& prevJsonObj,
+                              const QDomDocument& xmlDoc, QJsonArray *patch = nullptr);
+
 
 private:
+    // Converts the document instruction of the specialized conversions
+    friend class SchemaConverter;
+
+    /**
+     * @brief Scans the XML data read from the device. Returns false if a limit is exceeded.
+     */
+    static bool checkLimits(QIODevice *device, const ConversionLimits &limits, ConversionError *error);
+
     /**
      * @brief Returns the array of the element's attributes
      */
@@ -79,10 +116,40 @@ private:
      */
     static QJsonArray elements(QDomElement xmlElement);
 
+    /**
+     * @brief Returns the json object of a child element, text included
+     */
+    static QJsonObject element(const QDomElement &xmlElement);
+
     /**
      * @brief Returns the json object containing the processing instruction of the passed node
      */
     static QJsonObject processingInstruction(const QDomNode &xmlNode);
+
+    /**
+     * @brief Writes the json object of the element
+     */
+    static void writeElement(JsonWriter &writer, const QDomElement &xmlElement, bool hasText,
+                             const QString &parentPath, JsonIndexWriter *index);
+
+    /**
+     * @brief Updates the json object of an element, reconverting only the changed subtrees.
+     * Returns true if the json object changed.
+     */
+    static bool updateElement(const QDomElement &prevXmlElement, const QDomElement &xmlElement,
+                              QJsonObject &jsonObj, const QString &path, bool hasText, QJsonArray *patch,
+                              bool &mismatch);
+
+    /**
+     * @brief Returns true if the elements have the same attributes
+     */
+    static bool sameAttributes(const QDomElement &xmlElement, const QDomElement &otherXmlElement);
+
+    /**
+     * @brief Appends a JSON Patch (RFC 6902) operation to the patch, if any
+     */
+    static void addPatchOperation(QJsonArray *patch, const QString &op, const QString &path,
+                                  const QJsonValue &value = QJsonValue(QJsonValue::Undefined));
 };
 
 }
@@ -7,11 +7,32 @@ INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD 
 
 SOURCES += \
+    $$PWD/cpp/conversioncache.cpp \
+    $$PWD/cpp/conversionerror.cpp \
+    $$PWD/cpp/conversionoptions.cpp \
+    $$PWD/cpp/countingdevice.cpp \
+    $$PWD/cpp/jsonindex.cpp \
+    $$PWD/cpp/jsonindexwriter.cpp \
     $$PWD/cpp/jsontoxml.cpp \
+    $$PWD/cpp/jsonwriter.cpp \
+    $$PWD/cpp/limitschecker.cpp \
+    $$PWD/cpp/pipelinedconverter.cpp \
+    $$PWD/cpp/schemaconverter.cpp \
     $$PWD/cpp/xmltojson.cpp \
     $$PWD/xmljsonconverter.cpp
 
 HEADERS += \
+    $$PWD/cpp/conversioncache.h \
+    $$PWD/cpp/conversionerror.h \
+    $$PWD/cpp/conversionoptions.h \
+    $$PWD/cpp/countingdevice.h \
+    $$PWD/cpp/jsonindex.h \
+    $$PWD/cpp/jsonindexwriter.h \
     $$PWD/cpp/jsontoxml.h \
+    $$PWD/cpp/jsonwriter.h \
+    $$PWD/cpp/limitschecker.h \
+    $$PWD/cpp/pipelinedconverter.h \
+    $$PWD/cpp/schemaconverter.h \
+    $$PWD/cpp/spscqueue.h \
     $$PWD/cpp/xmltojson.h \
     $$PWD/xmljsonconverter.h
@@ -24,26 +24,94 @@ SOFTWARE.
 
 #include "xmljsonconverter.h"
 
+#include <QBuffer>
+
 namespace LTDev {
 
+ConversionCache *XmlJsonConverter::m_cache = nullptr;
+QHash<QString, SchemaConverter *> XmlJsonConverter::m_schemas;
+
 XmlJsonConverter::XmlJsonConverter()
 {
 }
 
 /**
- * Converts the XML file passed into a QJsonObject
+ * Converts the XML file passed into a QJsonObject. If a cache is set,
+ * the result is looked up by the content of the file before parsing it.
+ * The limits of the options are enforced while parsing, before choosing
+ * between the generic and the specialized conversion, so they apply to
+ * the documents of a registered schema too. On failure the error, if
+ * passed, is set and an empty object is returned.
  *
  * @param xmlFilePath: the path of the file to convert
+ * @param options: the conversion options
+ * @param error: the error set on failure, or nullptr
  *
  * @return QJsonObject
  */
-QJsonObject XmlJsonConverter::toJson(const QString &xmlFilePath)
+QJsonObject XmlJsonConverter::toJson(const QString &xmlFilePath, const ConversionOptions &options, ConversionError *error)
 {
-    return XmlToJson::convert(xmlFilePath);
+    ConversionError parseError;
+
+    if(!m_cache){
+        QDomDocument xmlDoc = XmlToJson::parse(xmlFilePath, options, &parseError);
+        if(parseError.hasError()){
+            if(error){
+                *error = parseError;
+            }
+            return QJsonObject();
+        }
+
+        return toJson(xmlDoc);
+    }
+
+    QFile f(xmlFilePath);
+    if(!f.open(QIODevice::ReadOnly)){
+        qWarning() << "Error while loading file: " << xmlFilePath;
+        ConversionError::set(error, ConversionError::FileOpenError, "Error while loading file: " + xmlFilePath);
+        return QJsonObject();
+    }
+
+    // Don't load oversized inputs in memory for hashing
+    qint64 maxInputBytes = options.limits.maxInputBytes;
+    if(maxInputBytes > 0 && f.size() > maxInputBytes){
+        ConversionError::set(error, ConversionError::InputTooLarge, QString("Input exceeds %1 bytes").arg(maxInputBytes));
+        return QJsonObject();
+    }
+
+    QByteArray input = f.readAll();
+    f.close();
+
+    // The limits are part of the key: an input accepted by a permissive caller must still be rejected
+    // by a stricter one, which reconverts it
+    QByteArray key = ConversionCache::key(input, ConversionCache::XmlToJsonDirection, options.id() + schemasId());
+
+    // Cache hit: skip the xml parsing and the conversion
+    QByteArray output;
+    if(m_cache->find(key, output)){
+        return QJsonDocument::fromJson(output).object();
+    }
+
+    QBuffer buffer(&input);
+    buffer.open(QIODevice::ReadOnly);
+
+    QDomDocument xmlDoc = XmlToJson::parse(&buffer, options, &parseError);
+    if(parseError.hasError()){
+        if(error){
+            *error = parseError;
+        }
+        return QJsonObject();
+    }
+
+    QJsonObject jsonObj = toJson(xmlDoc);
+    m_cache->insert(key, QJsonDocument(jsonObj).toJson(QJsonDocument::Compact));
+
+    return jsonObj;
 }
 
 /**
- * Converts the XML document passed into a QJsonObject
+ * Converts the XML document passed into a QJsonObject. If a schema converter
+ * is registered for the root element, the specialized conversion is used.
  *
  * @param xmlDoc: the xml document to convert
  *
@@ -51,6 +119,11 @@ QJsonObject XmlJsonConverter::toJson(const QString &xmlFilePath)
  */
 QJsonObject XmlJsonConverter::toJson(const QDomDocument &xmlDoc)
 {
+    SchemaConverter *schema = m_schemas.value(xmlDoc.documentElement().tagName());
+    if(schema){
+        return schema->convert(xmlDoc);
+    }
+
     return XmlToJson::convert(xmlDoc);
 }
 
@@ -67,7 +140,111 @@ QJsonObject XmlJsonConverter::toJson(const QDomElement &xmlElement)
 }
 
 /**
- * Converts the Json file passed into a QDomDocument
+ * Writes the json of the XML document passed to the device. The json is
+ * serialized while walking the document, unless a schema converter is
+ * registered for the root element. If an index device is passed, the byte
+ * range of each element is written into it, to be read by JsonIndex. The
+ * index is not available for the specialized conversions: the documents
+ * of a registered schema are rejected without writing anything.
+ *
+ * @param xmlDoc: the xml document to convert
+ * @param device: the open device to write to
+ * @param format: the output format
+ * @param index: the open device to write the index to, or nullptr
+ * @param error: set to the error, if any, or nullptr
+ *
+ * @return bool
+ */
+bool XmlJsonConverter::writeJson(const QDomDocument &xmlDoc, QIODevice *device, QJsonDocument::JsonFormat format,
+                                 QIODevice *index, ConversionError *error)
+{
+    bool written = false;
+
+    SchemaConverter *schema = m_schemas.value(xmlDoc.documentElement().tagName());
+    if(schema){
+        if(index){
+            qWarning() << "Index not available for the schema converter of: " << schema->rootTag();
+            ConversionError::set(error, ConversionError::WriteError,
+                                 "Index not available for the schema converter of: " + schema->rootTag());
+            return false;
+        }
+
+        QByteArray output = QJsonDocument(schema->convert(xmlDoc)).toJson(format);
+        written = device->write(output) == output.size();
+    } else {
+        written = XmlToJson::write(xmlDoc, device, format, index);
+    }
+
+    if(!written){
+        ConversionError::set(error, ConversionError::WriteError, "Error while writing json: " + device->errorString());
+    }
+
+    return written;
+}
+
+/**
+ * Converts the XML read from the input into the json written to the output
+ * with PipelinedConverter, without building the document in memory. The
+ * pipelined conversion doesn't use the schema converters: the registered
+ * root tags are passed to it, so their documents are rejected with an
+ * Unsupported error instead of being converted generically.
+ *
+ * @param input: the open device to read the XML from
+ * @param output: the open device to write the json to
+ * @param options: the conversion options
+ * @param format: the output format
+ * @param index: the open device to write the index to, or nullptr
+ * @param error: set to the error, if any, or nullptr
+ *
+ * @return bool
+ */
+bool XmlJsonConverter::writeJsonPipelined(QIODevice *input, QIODevice *output, const ConversionOptions &options,
+                                          QJsonDocument::JsonFormat format, QIODevice *index, ConversionError *error)
+{
+    return PipelinedConverter::convert(input, output, options, format, index, error, m_schemas.keys());
+}
+
+/**
+ * Updates the json previously converted from an XML document, reconverting
+ * only the changed subtrees. If a patch is passed, the JSON Patch (RFC 6902)
+ * operations describing the change are appended to it. If a schema converter
+ * is registered for either root element, the previous json may be typed and
+ * the generic subtrees can't be spliced into it: the new document is converted
+ * by toJson, and the patch replaces the whole document.
+ *
+ * @param prevXmlDoc: the xml document from which the previous json was converted
+ * @param prevJsonObj: the previous json
+ * @param xmlDoc: the new xml document
+ * @param patch: the array to which the patch operations are appended, or nullptr
+ *
+ * @return QJsonObject
+ */
+QJsonObject XmlJsonConverter::updateJson(const QDomDocument &prevXmlDoc, const QJsonObject &prevJsonObj,
+                                         const QDomDocument &xmlDoc, QJsonArray *patch)
+{
+    if(m_schemas.contains(prevXmlDoc.documentElement().tagName())
+            || m_schemas.contains(xmlDoc.documentElement().tagName())){
+        QJsonObject jsonObj = toJson(xmlDoc);
+
+        if(patch){
+            patch->append(QJsonObject {
+                              {"op", "replace"},
+                              {"path", ""},
+                              {"value", jsonObj}
+                          });
+        }
+
+        return jsonObj;
+    }
+
+    return XmlToJson::update(prevXmlDoc, prevJsonObj, xmlDoc, patch);
+}
+
+
+/**
+ * Converts the Json file passed into a QDomDocument. The conversion is not
+ * cached: a cached XML would have to be parsed into a QDomDocument again,
+ * which costs as much as the conversion and normalizes the document.
  *
  * @param jsonFilePath: the path of the file to convert
  *
@@ -75,11 +252,12 @@ QJsonObject XmlJsonConverter::toJson(const QDomElement &xmlElement)
  */
 QDomDocument XmlJsonConverter::toXml(const QString &jsonFilePath)
 {
-    return JsonToXml::convert(jsonFilePath);
+    return toXml(JsonToXml::parse(jsonFilePath));
 }
 
 /**
- * Converts the Json object passed into a QDomDocument
+ * Converts the Json object passed into a QDomDocument. If a schema converter
+ * is registered for the root element, the specialized conversion is used.
  *
  * @param jsonObj: the json to convert
  *
@@ -87,6 +265,15 @@ QDomDocument XmlJsonConverter::toXml(const QString &jsonFilePath)
  */
 QDomDocument XmlJsonConverter::toXml(const QJsonObject &jsonObj)
 {
+    // The json is a document only if it has both the root and the instruction, as for JsonToXml
+    bool isDocument = jsonObj.contains("root") && jsonObj.contains("instruction");
+    QJsonObject rootObj = isDocument ? jsonObj.value("root").toObject() : jsonObj;
+
+    SchemaConverter *schema = m_schemas.value(rootObj.value("tag").toString());
+    if(schema){
+        return schema->convert(jsonObj);
+    }
+
     return JsonToXml::convert(jsonObj);
 }
 
@@ -114,4 +301,65 @@ bool XmlJsonConverter::save(const QString &fileContent, const QString &filePath)
     return false;
 }
 
+/**
+ * Sets the cache used by the XML file conversions. The cache is not owned by
+ * the converter. Pass nullptr to disable caching.
+ *
+ * @param cache: the cache to use
+ */
+void XmlJsonConverter::setCache(ConversionCache *cache)
+{
+    m_cache = cache;
+}
+
+/**
+ * Returns the cache used by the file conversions, nullptr if caching is disabled
+ *
+ * @return ConversionCache*
+ */
+ConversionCache *XmlJsonConverter::cache()
+{
+    return m_cache;
+}
+
+/**
+ * Registers a schema converter, used by the conversions of the documents whose
+ * root element has the tag of the schema. The converter is not owned by the
+ * converter, and replaces any converter previously registered for the same tag.
+ * Registration is not thread safe: register the converters before converting.
+ *
+ * @param schema: the schema converter to register
+ */
+void XmlJsonConverter::registerSchema(SchemaConverter *schema)
+{
+    m_schemas.insert(schema->rootTag(), schema);
+}
+
+/**
+ * Unregisters the schema converter of the root tag passed
+ *
+ * @param rootTag: the tag of the root element of the schema
+ */
+void XmlJsonConverter::unregisterSchema(const QString &rootTag)
+{
+    m_schemas.remove(rootTag);
+}
+
+/**
+ * Returns the identifier of the registered schema converters, used as cache
+ * key options since the specialized conversions may emit typed values.
+ *
+ * @return QByteArray
+ */
+QByteArray XmlJsonConverter::schemasId()
+{
+    QStringList ids;
+    foreach (SchemaConverter *schema, m_schemas) {
+        ids.append(schema->id());
+    }
+    ids.sort();
+
+    return ids.join(",").toUtf8();
+}
+
 }
@@ -25,9 +25,15 @@ SOFTWARE.
 #ifndef XMLJSONCONVERTER_H
 #define XMLJSONCONVERTER_H
 
+#include "cpp/conversioncache.h"
+#include "cpp/jsonindex.h"
 #include "cpp/jsontoxml.h"
+#include "cpp/pipelinedconverter.h"
+#include "cpp/schemaconverter.h"
 #include "cpp/xmltojson.h"
 
+#include <QHash>
+
 
 namespace LTDev {
 
@@ -44,7 +50,8 @@ public:
     /**
      * @brief Converts the XML file passed into a QJsonObject
      */
-    static QJsonObject toJson(const QString& xmlFilePath);
+    static QJsonObject toJson(const QString& xmlFilePath, const ConversionOptions &options = ConversionOptions(),
+                              ConversionError *error = nullptr);
 
     /**
      * @brief Converts the XML document passed into a QJsonObject
@@ -56,6 +63,28 @@ public:
      */
     static QJsonObject toJson(const QDomElement& xmlElement);
 
+    /**
+     * @brief Writes the json of the XML document passed to the device, and its index if an index device is passed.
+     * Returns false on error.
+     */
+    static bool writeJson(const QDomDocument& xmlDoc, QIODevice *device,
+                          QJsonDocument::JsonFormat format = QJsonDocument::Indented, QIODevice *index = nullptr,
+                          ConversionError *error = nullptr);
+
+    /**
+     * @brief Converts the XML read from the input into the json written to the output with the pipelined conversion.
+     * The documents of a registered schema are rejected. Returns false on error.
+     */
+    static bool writeJsonPipelined(QIODevice *input, QIODevice *output, const ConversionOptions &options = ConversionOptions(),
+                                   QJsonDocument::JsonFormat format = QJsonDocument::Indented, QIODevice *index = nullptr,
+                                   ConversionError *error = nullptr);
+
+    /**
+     * @brief Updates the json previously converted from an XML document, reconverting only the changed subtrees
+     */
+    static QJsonObject updateJson(const QDomDocument &prevXmlDoc, const QJsonObject &prevJsonObj,
+                                  const QDomDocument &xmlDoc, QJsonArray *patch = nullptr);
+
     /**
      * @brief Converts the Json file passed into a QDomDocument
      */
@@ -70,6 +99,35 @@ public:
      * @brief Creates a file with the content passed. Returns true if creation is successfull, false otherwise.
      */
     static bool save(const QString &fileContent, const QString &filePath);
+
+    /**
+     * @brief Sets the cache used by the XML file conversions. Pass nullptr to disable caching.
+     */
+    static void setCache(ConversionCache *cache);
+
+    /**
+     * @brief Returns the cache used by the file conversions, nullptr if caching is disabled
+     */
+    static ConversionCache *cache();
+
+    /**
+     * @brief Registers a schema converter, used for the documents having its root tag
+     */
+    static void registerSchema(SchemaConverter *schema);
+
+    /**
+     * @brief Unregisters the schema converter of the root tag passed
+     */
+    static void unregisterSchema(const QString &rootTag);
+
+private:
+    /**
+     * @brief Returns the identifier of the registered schema converters
+     */
+    static QByteArray schemasId();
+
+    static ConversionCache *m_cache;
+    static QHash<QString, SchemaConverter *> m_schemas;
 };
 
 }
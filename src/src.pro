@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    qt-xml-json-library \
+    XmlJsonConverterSample \
+    XsdConverterGenerator \
+    XsdConverterBenchmark \
+    XmlJsonConverterDaemon \
+    XmlJsonConverterClient \
+    XmlJsonConverterCli \
+    tests
+
+# The benchmark and the tests generate their converters with the xsd2cpp tool
+XsdConverterBenchmark.depends = XsdConverterGenerator
+tests.depends = XsdConverterGenerator
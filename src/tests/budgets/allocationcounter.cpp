@@ -0,0 +1,248 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+std::atomic<quint64> allocations(0);
+std::atomic<qint64> live(0);
+std::atomic<qint64> peak(0);
+}
+
+#if defined(__GLIBC__)
+
+namespace {
+/**
+ * @brief Adds the bytes to the live ones, updating the peak
+ */
+void track(qint64 bytes)
+{
+    qint64 current = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    qint64 max = peak.load(std::memory_order_relaxed);
+
+    while(current > max && !peak.compare_exchange_weak(max, current, std::memory_order_relaxed)){
+    }
+}
+}
+
+// Qt containers allocate with malloc: with glibc the allocation functions are
+// replaced by counting wrappers of the glibc implementations, which also
+// serve operator new and the deallocations. The live bytes are the usable
+// sizes of the blocks.
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+void __libc_free(void *ptr);
+
+/**
+ * @brief Counts the allocation, and tracks the bytes of the returned block
+ */
+static void *allocated(void *ptr)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if(ptr){
+        track(qint64(malloc_usable_size(ptr)));
+    }
+
+    return ptr;
+}
+
+void *malloc(size_t size)
+{
+    return allocated(__libc_malloc(size));
+}
+
+void *calloc(size_t count, size_t size)
+{
+    return allocated(__libc_calloc(count, size));
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    qint64 prevBytes = ptr ? qint64(malloc_usable_size(ptr)) : 0;
+    void *p = __libc_realloc(ptr, size);
+
+    // On failure the block is unchanged, except for a zero size which frees it
+    if(p || size == 0){
+        track(-prevBytes);
+    }
+
+    return allocated(p);
+}
+
+void free(void *ptr)
+{
+    if(ptr){
+        track(-qint64(malloc_usable_size(ptr)));
+    }
+
+    __libc_free(ptr);
+}
+
+// The aligned allocations, used by the aligned operator new too. glibc only
+// exports __libc_memalign, which serves posix_memalign and aligned_alloc.
+void *memalign(size_t alignment, size_t size)
+{
+    return allocated(__libc_memalign(alignment, size));
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    if(alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0){
+        return EINVAL;
+    }
+
+    void *p = memalign(alignment, size);
+    if(!p){
+        return ENOMEM;
+    }
+
+    *ptr = p;
+    return 0;
+}
+
+void *valloc(size_t size)
+{
+    return allocated(__libc_valloc(size));
+}
+
+void *pvalloc(size_t size)
+{
+    return allocated(__libc_pvalloc(size));
+}
+
+}
+
+#else
+
+// Elsewhere only operator new is counted
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void *ptr = std::malloc(size ? size : 1);
+    if(!ptr){
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
+
+namespace LTDev {
+
+/**
+ * Returns the number of heap allocations since the start of the process
+ *
+ * @return quint64
+ */
+quint64 AllocationCounter::count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * Returns true if the allocations of the C library are counted, false if only operator new is
+ *
+ * @return bool
+ */
+bool AllocationCounter::countsMalloc()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/**
+ * Returns the heap bytes allocated and not freed yet. Only measured when the
+ * allocations of the C library are counted.
+ *
+ * @return qint64
+ */
+qint64 AllocationCounter::liveBytes()
+{
+    return live.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * Returns the maximum of the live bytes since the last reset
+ *
+ * @return qint64
+ */
+qint64 AllocationCounter::peakBytes()
+{
+    return peak.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * Resets the peak to the current live bytes
+ */
+void AllocationCounter::resetPeak()
+{
+    peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+
+namespace LTDev {
+
+class AllocationCounter
+{
+public:
+    /**
+     * @brief Returns the number of heap allocations since the start of the process
+     */
+    static quint64 count();
+
+    /**
+     * @brief Returns true if the allocations of the C library are counted, false if only operator new is
+     */
+    static bool countsMalloc();
+
+    /**
+     * @brief Returns the heap bytes allocated and not freed yet, 0 if not measured
+     */
+    static qint64 liveBytes();
+
+    /**
+     * @brief Returns the maximum of the live bytes since the last reset, 0 if not measured
+     */
+    static qint64 peakBytes();
+
+    /**
+     * @brief Resets the peak to the current live bytes
+     */
+    static void resetPeak();
+};
+
+}
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,27 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = tst_budgets
+
+SOURCES += \
+        allocationcounter.cpp \
+        tst_budgets.cpp
+
+HEADERS += \
+        allocationcounter.h
+
+DISTFILES += \
+    baseline.json
+
+# Baseline file path
+DEFINES += BASELINE_PATH=\\\"$$PWD/baseline.json\\\"
+
+# Include test corpora
+include(../shared/shared.pri)
+
+# Include library files
+include(../../qt-xml-json-library/qt-xml-json-library.pri)
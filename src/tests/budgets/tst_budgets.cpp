@@ -0,0 +1,318 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QVersionNumber>
+#include <QtTest>
+
+#include <functional>
+
+#include "allocationcounter.h"
+#include "corpus.h"
+#include "xmljsonconverter.h"
+
+using namespace LTDev;
+
+/**
+ * @brief Checks the heap allocations, the peak heap and the time per MB of the
+ * conversions against the baseline recorded in baseline.json.
+ *
+ * Environment variables:
+ *  - XMLJSON_BUDGET_RECORD=1: records the measures as the new baseline
+ *  - XMLJSON_BUDGET_BASELINE: path of the baseline file
+ *  - XMLJSON_BUDGET_MARGIN: allowed allocations increase, as a fraction of the baseline
+ *  - XMLJSON_BUDGET_TIME_MARGIN: allowed time increase, as a fraction of the baseline. Negative
+ *    disables the check, on machines slower than the reference one.
+ *  - XMLJSON_BUDGET_ALLOW_MISSING=1: skips the cases missing from the baseline instead of failing
+ *
+ * The baseline applies to the allocator hook and the Qt major.minor version
+ * it was recorded with: on another platform or Qt version the budgets are
+ * skipped with a message, since the allocations of Qt change between them.
+ */
+class BudgetTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void budget_data();
+    void budget();
+    void cleanupTestCase();
+
+private:
+    /**
+     * @brief Measures of an operation
+     */
+    struct Measure {
+        double allocationsPerMB;
+        double peakBytesPerMB;
+        double msPerMB;
+    };
+
+    /**
+     * @brief Runs the operation repeatedly and returns its measures
+     */
+    static Measure measure(const std::function<void()> &operation, qint64 bytes);
+
+    /**
+     * @brief Returns the major.minor version of the Qt library used
+     */
+    static QString qtMinorVersion();
+
+    QString m_baselinePath;
+    QJsonObject m_baseline;
+    QJsonObject m_measures;
+    double m_margin;
+    double m_timeMargin;
+    bool m_record;
+    bool m_allowMissing;
+};
+
+
+void BudgetTest::initTestCase()
+{
+    m_baselinePath = qEnvironmentVariableIsSet("XMLJSON_BUDGET_BASELINE")
+            ? QString::fromLocal8Bit(qgetenv("XMLJSON_BUDGET_BASELINE")) : QString(BASELINE_PATH);
+    m_record = qgetenv("XMLJSON_BUDGET_RECORD") == "1";
+    m_allowMissing = qgetenv("XMLJSON_BUDGET_ALLOW_MISSING") == "1";
+
+    QFile f(m_baselinePath);
+    if(f.open(QIODevice::ReadOnly)){
+        m_baseline = QJsonDocument::fromJson(f.readAll()).object();
+    } else if(!m_record && !m_allowMissing){
+        QFAIL(qPrintable("Missing baseline: " + m_baselinePath));
+    }
+
+    bool ok = false;
+    m_margin = qgetenv("XMLJSON_BUDGET_MARGIN").toDouble(&ok);
+    if(!ok){
+        m_margin = m_baseline.value("allocationMargin").toDouble(0.05);
+    }
+
+    m_timeMargin = qgetenv("XMLJSON_BUDGET_TIME_MARGIN").toDouble(&ok);
+    if(!ok){
+        m_timeMargin = m_baseline.value("timeMargin").toDouble(0.25);
+    }
+}
+
+
+void BudgetTest::budget_data()
+{
+    QTest::addColumn<QString>("operation");
+    QTest::addColumn<QByteArray>("xml");
+
+    QByteArray records = Corpus::records(5000);
+    QByteArray nested = Corpus::nested(8, 3);
+    QByteArray duplicated = Corpus::duplicated(5000);
+
+    QTest::newRow("convert/records") << QString("convert") << records;
+    QTest::newRow("convert/nested") << QString("convert") << nested;
+    QTest::newRow("convert/duplicated") << QString("convert") << duplicated;
+    QTest::newRow("write/records") << QString("write") << records;
+    QTest::newRow("toxml/records") << QString("toxml") << records;
+    QTest::newRow("pipelined/records") << QString("pipelined") << records;
+}
+
+
+/**
+ * Measures the operation on the parsed input, and compares the measures with
+ * the baseline increased by the margins. Parsing is left out: it is done by
+ * QDomDocument, and its cost would hide the changes of the conversions.
+ */
+void BudgetTest::budget()
+{
+    QFETCH(QString, operation);
+    QFETCH(QByteArray, xml);
+
+    QDomDocument xmlDoc;
+    QVERIFY(xmlDoc.setContent(xml));
+
+    QJsonObject jsonObj = XmlToJson::convert(xmlDoc);
+
+    std::function<void()> run;
+
+    if(operation == "convert"){
+        run = [&](){ XmlToJson::convert(xmlDoc); };
+    } else if(operation == "write"){
+        run = [&](){
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            XmlToJson::write(xmlDoc, &buffer);
+        };
+    } else if(operation == "pipelined"){
+        // From the raw input: the pipeline includes the tokenizing
+        run = [&](){
+            QBuffer input(&xml);
+            input.open(QIODevice::ReadOnly);
+            QBuffer output;
+            output.open(QIODevice::WriteOnly);
+            PipelinedConverter::convert(&input, &output);
+        };
+    } else {
+        run = [&](){ JsonToXml::convert(jsonObj); };
+    }
+
+    Measure m = measure(run, xml.size());
+    QString name = QTest::currentDataTag();
+
+    qInfo().noquote() << QString("%1: %2 allocations/MB, %3 peak KB/MB, %4 ms/MB").arg(name)
+                         .arg(m.allocationsPerMB, 0, 'f', 0).arg(m.peakBytesPerMB / 1024, 0, 'f', 0)
+                         .arg(m.msPerMB, 0, 'f', 2);
+
+    if(m_record){
+        m_measures.insert(name, QJsonObject{
+            {"allocationsPerMB", double(qRound64(m.allocationsPerMB))},
+            {"peakBytesPerMB", double(qRound64(m.peakBytesPerMB))},
+            {"msPerMB", m.msPerMB}
+        });
+        return;
+    }
+
+    // Allocations depend on the allocator hook and on the Qt version: a baseline
+    // recorded elsewhere doesn't apply
+    if(m_baseline.value("countsMalloc").toBool() != AllocationCounter::countsMalloc()
+            || m_baseline.value("qtVersion").toString() != qtMinorVersion()){
+        QSKIP(qPrintable(QString("No baseline recorded for Qt %1%2: run with XMLJSON_BUDGET_RECORD=1")
+                         .arg(qtMinorVersion(), AllocationCounter::countsMalloc() ? "" : " without the allocator hook")));
+    }
+
+    QJsonObject baseline = m_baseline.value("cases").toObject().value(name).toObject();
+
+    if(baseline.isEmpty()){
+        QString message = QString("No baseline recorded for %1: run with XMLJSON_BUDGET_RECORD=1").arg(name);
+
+        if(m_allowMissing){
+            QSKIP(qPrintable(message));
+        }
+        QFAIL(qPrintable(message));
+    }
+
+    double allocationsBudget = baseline.value("allocationsPerMB").toDouble() * (1 + m_margin);
+    QVERIFY2(m.allocationsPerMB <= allocationsBudget,
+             qPrintable(QString("%1 allocations/MB exceed the budget of %2").arg(m.allocationsPerMB, 0, 'f', 0).arg(allocationsBudget, 0, 'f', 0)));
+
+    // The peak heap is measured with the allocations of the C library only
+    if(AllocationCounter::countsMalloc()){
+        double peakBudget = baseline.value("peakBytesPerMB").toDouble() * (1 + m_margin);
+        QVERIFY2(m.peakBytesPerMB <= peakBudget,
+                 qPrintable(QString("%1 peak bytes/MB exceed the budget of %2").arg(m.peakBytesPerMB, 0, 'f', 0).arg(peakBudget, 0, 'f', 0)));
+    }
+
+    if(m_timeMargin >= 0){
+        double timeBudget = baseline.value("msPerMB").toDouble() * (1 + m_timeMargin);
+        QVERIFY2(m.msPerMB <= timeBudget,
+                 qPrintable(QString("%1 ms/MB exceed the budget of %2").arg(m.msPerMB, 0, 'f', 2).arg(timeBudget, 0, 'f', 2)));
+    }
+}
+
+
+/**
+ * Writes the recorded measures as the new baseline, keeping the margins
+ */
+void BudgetTest::cleanupTestCase()
+{
+    if(!m_record){
+        return;
+    }
+
+    QJsonObject cases = m_baseline.value("cases").toObject();
+    for(QJsonObject::const_iterator it = m_measures.constBegin(); it != m_measures.constEnd(); ++it){
+        cases.insert(it.key(), it.value());
+    }
+
+    m_baseline.insert("allocationMargin", m_baseline.value("allocationMargin").toDouble(0.05));
+    m_baseline.insert("timeMargin", m_baseline.value("timeMargin").toDouble(0.25));
+    m_baseline.insert("countsMalloc", AllocationCounter::countsMalloc());
+    m_baseline.insert("qtVersion", qtMinorVersion());
+    m_baseline.insert("cases", cases);
+
+    QFile f(m_baselinePath);
+    QVERIFY2(f.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable("Error while writing baseline: " + m_baselinePath));
+    f.write(QJsonDocument(m_baseline).toJson());
+
+    qInfo().noquote() << "Baseline recorded:" << m_baselinePath;
+}
+
+
+/**
+ * Runs the operation once to warm up, measuring its peak heap over the live
+ * bytes, then repeatedly for at least 200 ms and three runs. Returns the heap
+ * allocations, the peak heap and the time per MB of input.
+ *
+ * @param operation: the operation to measure
+ * @param bytes: the size of the input
+ *
+ * @return Measure
+ */
+BudgetTest::Measure BudgetTest::measure(const std::function<void()> &operation, qint64 bytes)
+{
+    AllocationCounter::resetPeak();
+    qint64 liveBytes = AllocationCounter::liveBytes();
+
+    operation();
+
+    qint64 peakBytes = AllocationCounter::peakBytes() - liveBytes;
+
+    int runs = 0;
+    quint64 allocations = AllocationCounter::count();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    do {
+        operation();
+        runs++;
+    } while(runs < 3 || timer.elapsed() < 200);
+
+    qint64 elapsedNs = timer.nsecsElapsed();
+    allocations = AllocationCounter::count() - allocations;
+
+    double mb = runs * bytes / (1024.0 * 1024.0);
+
+    Measure m;
+    m.allocationsPerMB = allocations / mb;
+    m.peakBytesPerMB = peakBytes / (bytes / (1024.0 * 1024.0));
+    m.msPerMB = elapsedNs / 1e6 / mb;
+
+    return m;
+}
+
+
+/**
+ * Returns the major.minor version of the Qt library used: patch releases
+ * don't change the allocations of the conversions
+ *
+ * @return QString
+ */
+QString BudgetTest::qtMinorVersion()
+{
+    QVersionNumber version = QVersionNumber::fromString(QString(qVersion()));
+
+    return QString("%1.%2").arg(version.majorVersion()).arg(version.minorVersion());
+}
+
+QTEST_GUILESS_MAIN(BudgetTest)
+
+#include "tst_budgets.moc"
@@ -0,0 +1,26 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = tst_conversion
+
+SOURCES += \
+        tst_conversion.cpp
+
+# Include test corpora
+include(../shared/shared.pri)
+
+# Include library files
+include(../../qt-xml-json-library/qt-xml-json-library.pri)
+
+# Generate the converters specialized for the shiporder schema, untyped and typed
+include(../../XsdConverterGenerator/xsd2cpp.pri)
+
+XSD_SOURCES += \
+    ../../XmlJsonConverterSample/samples/4_sample_xsd_shiporder.xsd
+
+XSD_TYPED_SOURCES += \
+    ../../XmlJsonConverterSample/samples/4_sample_xsd_shiporder.xsd
@@ -0,0 +1,717 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QBuffer>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "corpus.h"
+#include "xmljsonconverter.h"
+#include "4_sample_xsd_shiporder_converter.h"
+#include "4_sample_xsd_shiporder_typed_converter.h"
+
+using namespace LTDev;
+
+class ConversionTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void cache();
+    void cacheOptions();
+    void cacheLimits();
+    void cacheEviction();
+    void update_data();
+    void update();
+    void updateMismatch();
+    void updateSchema();
+    void schemaConverter();
+    void typedSchemaConverter();
+    void limits_data();
+    void limits();
+    void schemaLimits();
+    void pipelinedUnsupported();
+
+private:
+    /**
+     * @brief Returns the json with the attributes sorted by key, since their order isn't preserved by QDomDocument
+     */
+    static QJsonObject normalized(const QJsonObject &jsonObj);
+
+    /**
+     * @brief Returns the json with the JSON Patch (RFC 6902) operations applied
+     */
+    static QJsonObject applyPatch(const QJsonObject &jsonObj, const QJsonArray &patch);
+
+    /**
+     * @brief Returns the json value with the operation applied at the path passed
+     */
+    static QJsonValue applyOperation(const QJsonValue &value, const QStringList &path,
+                                     const QString &op, const QJsonValue &operand);
+
+    /**
+     * @brief Returns the shiporder sample document
+     */
+    static QDomDocument shiporder();
+
+    /**
+     * @brief Returns the document checked against the limits
+     */
+    static QByteArray limitsXml();
+
+    /**
+     * @brief Returns the json serialized and parsed again
+     */
+    static QJsonObject reparsed(const QJsonObject &jsonObj);
+
+    /**
+     * @brief Writes the data into a file of the directory. Returns the file path.
+     */
+    static QString writeFile(const QTemporaryDir &dir, const QString &fileName, const QByteArray &data);
+};
+
+
+/**
+ * The cache and the schema converters are global: reset them after each test
+ */
+void ConversionTest::cleanup()
+{
+    XmlJsonConverter::setCache(nullptr);
+    XmlJsonConverter::unregisterSchema("shiporder");
+}
+
+
+/**
+ * A cached conversion must return the json of the uncached one, without
+ * converting the file again
+ */
+void ConversionTest::cache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString xmlPath = writeFile(dir, "records.xml", Corpus::records(100));
+    QJsonObject jsonObj = XmlJsonConverter::toJson(xmlPath);
+
+    ConversionCache cache(dir.filePath("cache"));
+    XmlJsonConverter::setCache(&cache);
+
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath), jsonObj);
+    QCOMPARE(cache.misses(), quint64(1));
+    QCOMPARE(cache.hits(), quint64(0));
+
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath), jsonObj);
+    QCOMPARE(cache.misses(), quint64(1));
+    QCOMPARE(cache.hits(), quint64(1));
+
+    // The entries survive a restart
+    ConversionCache reloaded(dir.filePath("cache"));
+    XmlJsonConverter::setCache(&reloaded);
+
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath), jsonObj);
+    QCOMPARE(reloaded.hits(), quint64(1));
+}
+
+
+/**
+ * The options are part of the cache key: different options must not share the entries
+ */
+void ConversionTest::cacheOptions()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString xmlPath = writeFile(dir, "duplicated.xml", Corpus::duplicated(50));
+
+    ConversionCache cache(dir.filePath("cache"));
+    XmlJsonConverter::setCache(&cache);
+
+    // A limit not reached doesn't change the output, but still the key
+    ConversionOptions options;
+    options.limits.maxDepth = 100;
+
+    QJsonObject jsonObj = XmlJsonConverter::toJson(xmlPath);
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, options), jsonObj);
+    QCOMPARE(cache.misses(), quint64(2));
+}
+
+
+/**
+ * A document cached by a permissive conversion must still be rejected by a
+ * stricter one
+ */
+void ConversionTest::cacheLimits()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString xmlPath = writeFile(dir, "records.xml", Corpus::records(50));
+
+    ConversionCache cache(dir.filePath("cache"));
+    XmlJsonConverter::setCache(&cache);
+
+    ConversionError error;
+    QJsonObject jsonObj = XmlJsonConverter::toJson(xmlPath, ConversionOptions(), &error);
+    QVERIFY(!error.hasError());
+    QVERIFY(!jsonObj.isEmpty());
+
+    ConversionOptions options;
+    options.limits.maxElements = 10;
+
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, options, &error), QJsonObject());
+    QCOMPARE(error.code, ConversionError::TooManyElements);
+
+    // The rejected conversion isn't cached
+    error = ConversionError();
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, options, &error), QJsonObject());
+    QCOMPARE(error.code, ConversionError::TooManyElements);
+    QCOMPARE(cache.hits(), quint64(0));
+
+    error = ConversionError();
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, ConversionOptions(), &error), jsonObj);
+    QVERIFY(!error.hasError());
+    QCOMPARE(cache.hits(), quint64(1));
+}
+
+
+/**
+ * The cache must stay within its maximum size, evicting the least recently
+ * used entries first and rejecting the outputs bigger than the whole cache,
+ * and rebuild the eviction order from the access times after a restart
+ */
+void ConversionTest::cacheEviction()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString cachePath = dir.filePath("cache");
+    QByteArray output(100, 'x'), found;
+
+    QByteArray a = ConversionCache::key("a", ConversionCache::XmlToJsonDirection);
+    QByteArray b = ConversionCache::key("b", ConversionCache::XmlToJsonDirection);
+    QByteArray c = ConversionCache::key("c", ConversionCache::XmlToJsonDirection);
+    QByteArray d = ConversionCache::key("d", ConversionCache::XmlToJsonDirection);
+    QByteArray e = ConversionCache::key("e", ConversionCache::XmlToJsonDirection);
+
+    {
+        ConversionCache cache(cachePath, 300);
+
+        QVERIFY(cache.insert(a, output));
+        QVERIFY(cache.insert(b, output));
+        QVERIFY(cache.insert(c, output));
+        QCOMPARE(cache.size(), qint64(300));
+
+        // Reading a leaves b as the least recently used entry
+        QVERIFY(cache.find(a, found));
+        QVERIFY(cache.insert(d, output));
+        QCOMPARE(cache.size(), qint64(300));
+        QVERIFY(!cache.find(b, found));
+        QVERIFY(!QFile::exists(cachePath + "/" + b + ".cache"));
+
+        // An output bigger than the whole cache is rejected, without evicting anything
+        QVERIFY(!cache.insert(e, QByteArray(301, 'x')));
+        QCOMPARE(cache.size(), qint64(300));
+        QVERIFY(!QFile::exists(cachePath + "/" + e + ".cache"));
+    }
+
+    // Access times from the oldest: d, c, a
+    QDateTime now = QDateTime::currentDateTime();
+    QList<QByteArray> order = QList<QByteArray>() << d << c << a;
+
+    for(int i=0; i<order.size(); i++){
+        QFile f(cachePath + "/" + order.at(i) + ".cache");
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        QVERIFY(f.setFileTime(now.addSecs(60 * (i - order.size())), QFileDevice::FileModificationTime));
+    }
+
+    // A smaller cache evicts the oldest entry on load, then the next one on insert
+    ConversionCache reloaded(cachePath, 200);
+    QCOMPARE(reloaded.size(), qint64(200));
+    QVERIFY(!QFile::exists(cachePath + "/" + d + ".cache"));
+
+    QVERIFY(reloaded.insert(e, output));
+    QVERIFY(!QFile::exists(cachePath + "/" + c + ".cache"));
+
+    QVERIFY(reloaded.find(a, found));
+    QCOMPARE(found, output);
+    QVERIFY(reloaded.find(e, found));
+    QVERIFY(!reloaded.find(c, found));
+    QVERIFY(!reloaded.find(d, found));
+}
+
+
+void ConversionTest::update_data()
+{
+    QTest::addColumn<QByteArray>("prevXml");
+    QTest::addColumn<QByteArray>("xml");
+
+    QTest::newRow("unchanged") << QByteArray("<r><a x='1'>t</a></r>") << QByteArray("<r><a x='1'>t</a></r>");
+    QTest::newRow("attribute changed") << QByteArray("<r><a x='1' y='2'/></r>") << QByteArray("<r><a x='1' y='3'/></r>");
+    QTest::newRow("attribute added") << QByteArray("<r><a x='1'/></r>") << QByteArray("<r><a x='1' y='2'/></r>");
+    QTest::newRow("attribute removed") << QByteArray("<r x='1'><a/></r>") << QByteArray("<r><a/></r>");
+    QTest::newRow("text changed") << QByteArray("<r><a>1</a><b>2</b></r>") << QByteArray("<r><a>1</a><b>3</b></r>");
+    QTest::newRow("child inserted") << QByteArray("<r><a/><b/></r>") << QByteArray("<r><a/><c/><b/></r>");
+    QTest::newRow("child appended") << QByteArray("<r><a/></r>") << QByteArray("<r><a/><b><c>t</c></b></r>");
+    QTest::newRow("child removed") << QByteArray("<r><a/><b/><c/></r>") << QByteArray("<r><a/><c/></r>");
+    QTest::newRow("children reordered") << QByteArray("<r><a>1</a><b x='2'>2</b></r>") << QByteArray("<r><b x='2'>2</b><a>1</a></r>");
+    QTest::newRow("leaf to parent") << QByteArray("<r><a>t</a></r>") << QByteArray("<r><a><b>t</b></a></r>");
+    QTest::newRow("parent to leaf") << QByteArray("<r><a><b>t</b></a></r>") << QByteArray("<r><a>t</a></r>");
+    QTest::newRow("root replaced") << QByteArray("<r><a/></r>") << QByteArray("<s><a/></s>");
+    QTest::newRow("instruction changed") << QByteArray("<?xml version='1.0'?><r/>")
+                                         << QByteArray("<?xml version='1.0' encoding='UTF-8'?><r/>");
+    QTest::newRow("records changed") << Corpus::records(200, 1) << Corpus::records(200, 2);
+    QTest::newRow("records appended") << Corpus::records(150) << Corpus::records(200);
+    QTest::newRow("records removed") << Corpus::records(200) << Corpus::records(150);
+    QTest::newRow("nested changed") << Corpus::nested(5, 3, 1) << Corpus::nested(5, 3, 2);
+}
+
+
+/**
+ * The updated json must be the converted one, and applying the patch to the
+ * previous json must give it too
+ */
+void ConversionTest::update()
+{
+    QFETCH(QByteArray, prevXml);
+    QFETCH(QByteArray, xml);
+
+    QDomDocument prevXmlDoc, xmlDoc;
+    QVERIFY(prevXmlDoc.setContent(prevXml));
+    QVERIFY(xmlDoc.setContent(xml));
+
+    QJsonObject prevJsonObj = XmlToJson::convert(prevXmlDoc);
+    QJsonObject jsonObj = normalized(XmlToJson::convert(xmlDoc));
+
+    QJsonArray patch;
+    QCOMPARE(normalized(XmlJsonConverter::updateJson(prevXmlDoc, prevJsonObj, xmlDoc, &patch)), jsonObj);
+    QCOMPARE(normalized(applyPatch(prevJsonObj, patch)), jsonObj);
+
+    if(prevXml == xml){
+        QVERIFY(patch.isEmpty());
+    }
+}
+
+
+/**
+ * A previous json not converted from the previous document must not be
+ * spliced: the whole document is converted again
+ */
+void ConversionTest::updateMismatch()
+{
+    QDomDocument prevXmlDoc, otherXmlDoc, xmlDoc;
+    QVERIFY(prevXmlDoc.setContent(QByteArray("<r><a/><b/></r>")));
+    QVERIFY(otherXmlDoc.setContent(QByteArray("<r><a/></r>")));
+    QVERIFY(xmlDoc.setContent(QByteArray("<r><a/><b/><c/></r>")));
+
+    QJsonObject prevJsonObj = XmlToJson::convert(otherXmlDoc);
+    QJsonObject jsonObj = XmlToJson::convert(xmlDoc);
+
+    QJsonArray patch;
+    QCOMPARE(XmlJsonConverter::updateJson(prevXmlDoc, prevJsonObj, xmlDoc, &patch), jsonObj);
+    QCOMPARE(patch.size(), 1);
+    QCOMPARE(applyPatch(prevJsonObj, patch), jsonObj);
+}
+
+
+/**
+ * With a schema converter the previous json is typed: the update must give the
+ * json of the specialized conversion
+ */
+void ConversionTest::updateSchema()
+{
+    ShiporderTypedConverter converter;
+    XmlJsonConverter::registerSchema(&converter);
+
+    QDomDocument prevXmlDoc = shiporder();
+    QDomDocument xmlDoc = shiporder();
+
+    QDomElement quantity = xmlDoc.documentElement().firstChildElement("item").firstChildElement("quantity");
+    quantity.firstChild().setNodeValue("2");
+
+    QJsonObject prevJsonObj = XmlJsonConverter::toJson(prevXmlDoc);
+    QJsonObject jsonObj = XmlJsonConverter::toJson(xmlDoc);
+
+    QJsonArray patch;
+    QCOMPARE(XmlJsonConverter::updateJson(prevXmlDoc, prevJsonObj, xmlDoc, &patch), jsonObj);
+    QCOMPARE(applyPatch(prevJsonObj, patch), jsonObj);
+}
+
+
+/**
+ * The specialized conversions must give the json and the xml of the generic ones,
+ * declared elements or not
+ */
+void ConversionTest::schemaConverter()
+{
+    QDomDocument xmlDoc = shiporder();
+
+    // Elements not declared by the schema use the generic path
+    QDomDocument extendedXmlDoc = shiporder();
+    QDomElement extra = extendedXmlDoc.createElement("extra");
+    extra.setAttribute("key", "value");
+    extra.appendChild(extendedXmlDoc.createElement("child")).appendChild(extendedXmlDoc.createTextNode("text"));
+    extendedXmlDoc.documentElement().firstChildElement("shipto").appendChild(extra);
+
+    QList<QJsonObject> jsonObjs;
+    QStringList xmls;
+
+    foreach (const QDomDocument &doc, QList<QDomDocument>() << xmlDoc << extendedXmlDoc) {
+        jsonObjs.append(XmlToJson::convert(doc));
+        xmls.append(JsonToXml::convert(jsonObjs.last()).toString());
+    }
+
+    ShiporderConverter converter;
+    XmlJsonConverter::registerSchema(&converter);
+
+    QCOMPARE(XmlJsonConverter::toJson(xmlDoc), jsonObjs.at(0));
+    QCOMPARE(XmlJsonConverter::toXml(jsonObjs.at(0)).toString(), xmls.at(0));
+    QCOMPARE(XmlJsonConverter::toJson(extendedXmlDoc), jsonObjs.at(1));
+    QCOMPARE(XmlJsonConverter::toXml(jsonObjs.at(1)).toString(), xmls.at(1));
+}
+
+
+/**
+ * The typed conversion must emit the canonical numbers as json numbers, and keep
+ * the other values as strings, so that the xml converted back is the original one
+ */
+void ConversionTest::typedSchemaConverter()
+{
+    QDomDocument xmlDoc = shiporder();
+
+    QDomDocument nonCanonicalXmlDoc;
+    QVERIFY(nonCanonicalXmlDoc.setContent(QByteArray(
+                "<shiporder orderid='1'><orderperson>A</orderperson>"
+                "<shipto><name>B</name><address>C</address><city>D</city><country>E</country></shipto>"
+                "<item><title>F</title><quantity>007</quantity><price>1e1</price></item>"
+                "<item><title>G</title><quantity>+3</quantity><price>1.0</price></item>"
+                "</shiporder>")));
+
+    QStringList xmls;
+    foreach (const QDomDocument &doc, QList<QDomDocument>() << xmlDoc << nonCanonicalXmlDoc) {
+        xmls.append(JsonToXml::convert(XmlToJson::convert(doc)).toString());
+    }
+
+    ShiporderTypedConverter converter;
+    XmlJsonConverter::registerSchema(&converter);
+
+    QJsonObject jsonObj = reparsed(XmlJsonConverter::toJson(xmlDoc));
+    QJsonArray item = jsonObj.value("root").toObject().value("elements").toArray().at(2).toObject().value("elements").toArray();
+
+    QCOMPARE(item.at(2).toObject().value("text"), QJsonValue(1));
+    QCOMPARE(item.at(3).toObject().value("text"), QJsonValue("10.90"));
+    QCOMPARE(XmlJsonConverter::toXml(jsonObj).toString(), xmls.at(0));
+
+    QJsonObject nonCanonicalJsonObj = reparsed(XmlJsonConverter::toJson(nonCanonicalXmlDoc));
+    QCOMPARE(nonCanonicalJsonObj, reparsed(XmlToJson::convert(nonCanonicalXmlDoc)));
+    QCOMPARE(XmlJsonConverter::toXml(nonCanonicalJsonObj).toString(), xmls.at(1));
+}
+
+
+void ConversionTest::limits_data()
+{
+    QTest::addColumn<QString>("limit");
+    QTest::addColumn<qint64>("value");
+    QTest::addColumn<int>("code");
+
+    qint64 inputBytes = limitsXml().size();
+
+    QTest::newRow("input bytes exceeded") << "maxInputBytes" << inputBytes - 1 << int(ConversionError::InputTooLarge);
+    QTest::newRow("input bytes") << "maxInputBytes" << inputBytes << int(ConversionError::NoError);
+    QTest::newRow("elements exceeded") << "maxElements" << qint64(3) << int(ConversionError::TooManyElements);
+    QTest::newRow("elements") << "maxElements" << qint64(4) << int(ConversionError::NoError);
+    QTest::newRow("depth exceeded") << "maxDepth" << qint64(2) << int(ConversionError::TooDeep);
+    QTest::newRow("depth") << "maxDepth" << qint64(3) << int(ConversionError::NoError);
+    QTest::newRow("attributes exceeded") << "maxAttributes" << qint64(1) << int(ConversionError::TooManyAttributes);
+    QTest::newRow("attributes") << "maxAttributes" << qint64(2) << int(ConversionError::NoError);
+    QTest::newRow("text exceeded") << "maxTextLength" << qint64(4) << int(ConversionError::TextTooLong);
+    QTest::newRow("text") << "maxTextLength" << qint64(5) << int(ConversionError::NoError);
+    QTest::newRow("output bytes exceeded") << "maxOutputBytes" << qint64(64) << int(ConversionError::OutputTooLarge);
+    QTest::newRow("output bytes") << "maxOutputBytes" << qint64(1024) << int(ConversionError::NoError);
+}
+
+
+/**
+ * The DOM path must stop at the exceeded limit, from a file and from a device,
+ * and convert the document within the limits; so must the pipelined conversion
+ */
+void ConversionTest::limits()
+{
+    QFETCH(QString, limit);
+    QFETCH(qint64, value);
+    QFETCH(int, code);
+
+    QByteArray xml = limitsXml();
+
+    ConversionOptions options;
+    if(limit == "maxInputBytes"){
+        options.limits.maxInputBytes = value;
+    } else if(limit == "maxElements"){
+        options.limits.maxElements = value;
+    } else if(limit == "maxDepth"){
+        options.limits.maxDepth = int(value);
+    } else if(limit == "maxAttributes"){
+        options.limits.maxAttributes = int(value);
+    } else if(limit == "maxTextLength"){
+        options.limits.maxTextLength = value;
+    } else {
+        options.limits.maxOutputBytes = value;
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString xmlPath = writeFile(dir, "limits.xml", xml);
+
+    QDomDocument xmlDoc;
+    QVERIFY(xmlDoc.setContent(xml));
+    QJsonObject expected = code == ConversionError::NoError ? XmlToJson::convert(xmlDoc) : QJsonObject();
+
+    ConversionError error;
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, options, &error), expected);
+    QCOMPARE(int(error.code), code);
+
+    QBuffer buffer(&xml);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    error = ConversionError();
+    XmlToJson::parse(&buffer, options, &error);
+    QCOMPARE(int(error.code), code);
+
+    // The output size is estimated as on the DOM path, whatever the format
+    foreach (QJsonDocument::JsonFormat format, QList<QJsonDocument::JsonFormat>() << QJsonDocument::Compact << QJsonDocument::Indented) {
+        QBuffer output;
+        QVERIFY(buffer.seek(0));
+        QVERIFY(output.open(QIODevice::WriteOnly));
+
+        error = ConversionError();
+        QCOMPARE(PipelinedConverter::convert(&buffer, &output, options, format, nullptr, &error),
+                 code == ConversionError::NoError);
+        QCOMPARE(int(error.code), code);
+    }
+}
+
+
+/**
+ * The options apply to the specialized conversions too: the file conversion
+ * must enforce the limits before using the schema converter, as the generic
+ * one does, and the pipelined conversion must reject the schema instead
+ */
+void ConversionTest::schemaLimits()
+{
+    QString xmlPath = QString(SAMPLES_PATH) + "/2_sample_xml_shiporder.xml";
+
+    ShiporderTypedConverter converter;
+    XmlJsonConverter::registerSchema(&converter);
+
+    ConversionOptions options;
+    options.limits.maxDepth = 1;
+
+    ConversionError error;
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, options, &error), QJsonObject());
+    QCOMPARE(error.code, ConversionError::TooDeep);
+
+    options.limits.maxDepth = 100;
+
+    error = ConversionError();
+    QCOMPARE(XmlJsonConverter::toJson(xmlPath, options, &error), converter.convert(shiporder()));
+    QCOMPARE(error.code, ConversionError::NoError);
+
+    QFile input(xmlPath);
+    QBuffer output;
+    QVERIFY(input.open(QIODevice::ReadOnly));
+    QVERIFY(output.open(QIODevice::WriteOnly));
+
+    QVERIFY(!XmlJsonConverter::writeJsonPipelined(&input, &output, options, QJsonDocument::Indented, nullptr, &error));
+    QCOMPARE(error.code, ConversionError::Unsupported);
+}
+
+
+/**
+ * The pipelined conversion doesn't use the schema converters: the facade must
+ * fail instead of ignoring them, and the converter must reject the root tags
+ * passed
+ */
+void ConversionTest::pipelinedUnsupported()
+{
+    QFile f(QString(SAMPLES_PATH) + "/2_sample_xml_shiporder.xml");
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    QByteArray xml = f.readAll();
+
+    QBuffer input(&xml);
+    QBuffer output;
+    QVERIFY(input.open(QIODevice::ReadOnly));
+    QVERIFY(output.open(QIODevice::WriteOnly));
+
+    ConversionError error;
+    QVERIFY(PipelinedConverter::convert(&input, &output, ConversionOptions(), QJsonDocument::Indented, nullptr, &error));
+
+    QVERIFY(input.seek(0));
+    QVERIFY(!PipelinedConverter::convert(&input, &output, ConversionOptions(), QJsonDocument::Indented, nullptr, &error,
+                                         QStringList() << "shiporder"));
+    QCOMPARE(error.code, ConversionError::Unsupported);
+
+    ShiporderTypedConverter converter;
+    XmlJsonConverter::registerSchema(&converter);
+
+    QVERIFY(input.seek(0));
+    error = ConversionError();
+    QVERIFY(!XmlJsonConverter::writeJsonPipelined(&input, &output, ConversionOptions(), QJsonDocument::Indented, nullptr, &error));
+    QCOMPARE(error.code, ConversionError::Unsupported);
+}
+
+
+QJsonObject ConversionTest::normalized(const QJsonObject &jsonObj)
+{
+    QJsonObject normalizedObj = jsonObj;
+
+    if(jsonObj.contains("root")){
+        normalizedObj.insert("root", normalized(jsonObj.value("root").toObject()));
+        return normalizedObj;
+    }
+
+    QMap<QString, QJsonValue> sortedAttributes;
+    foreach (const QJsonValue &attr, jsonObj.value("attributes").toArray()) {
+        sortedAttributes.insert(attr.toObject().value("key").toString(), attr);
+    }
+
+    QJsonArray attributesArray;
+    foreach (const QJsonValue &attr, sortedAttributes) {
+        attributesArray.append(attr);
+    }
+
+    QJsonArray elementsArray;
+    foreach (const QJsonValue &element, jsonObj.value("elements").toArray()) {
+        elementsArray.append(normalized(element.toObject()));
+    }
+
+    normalizedObj.insert("attributes", attributesArray);
+    normalizedObj.insert("elements", elementsArray);
+
+    return normalizedObj;
+}
+
+
+QJsonObject ConversionTest::applyPatch(const QJsonObject &jsonObj, const QJsonArray &patch)
+{
+    QJsonValue value = jsonObj;
+
+    foreach (const QJsonValue &v, patch) {
+        QJsonObject operation = v.toObject();
+
+        // JSON Pointer: the empty path is the whole document, the tokens follow a slash
+        QStringList path = operation.value("path").toString().split('/');
+        path.removeFirst();
+
+        for(int i=0; i<path.size(); i++){
+            path[i].replace("~1", "/").replace("~0", "~");
+        }
+
+        value = applyOperation(value, path, operation.value("op").toString(), operation.value("value"));
+    }
+
+    return value.toObject();
+}
+
+
+QJsonValue ConversionTest::applyOperation(const QJsonValue &value, const QStringList &path,
+                                          const QString &op, const QJsonValue &operand)
+{
+    if(path.isEmpty()){
+        return operand;
+    }
+
+    const QString &token = path.first();
+    bool last = path.size() == 1;
+
+    if(value.isObject()){
+        QJsonObject obj = value.toObject();
+
+        if(!last){
+            obj.insert(token, applyOperation(obj.value(token), path.mid(1), op, operand));
+        } else if(op == "remove"){
+            obj.remove(token);
+        } else {
+            obj.insert(token, operand);
+        }
+
+        return obj;
+    }
+
+    QJsonArray array = value.toArray();
+    int i = token == "-" ? array.size() : token.toInt();
+
+    if(!last){
+        array.replace(i, applyOperation(array.at(i), path.mid(1), op, operand));
+    } else if(op == "add"){
+        array.insert(i, operand);
+    } else if(op == "remove"){
+        array.removeAt(i);
+    } else {
+        array.replace(i, operand);
+    }
+
+    return array;
+}
+
+
+QDomDocument ConversionTest::shiporder()
+{
+    QDomDocument xmlDoc;
+
+    QFile f(QString(SAMPLES_PATH) + "/2_sample_xml_shiporder.xml");
+    if(!f.open(QIODevice::ReadOnly) || !xmlDoc.setContent(&f)){
+        qWarning() << "Error while loading file: " << f.fileName();
+    }
+
+    return xmlDoc;
+}
+
+
+QByteArray ConversionTest::limitsXml()
+{
+    return QByteArray("<root a=\"1\" b=\"2\"><child>hello</child><child><leaf>text</leaf></child></root>");
+}
+
+
+QJsonObject ConversionTest::reparsed(const QJsonObject &jsonObj)
+{
+    return QJsonDocument::fromJson(QJsonDocument(jsonObj).toJson()).object();
+}
+
+
+QString ConversionTest::writeFile(const QTemporaryDir &dir, const QString &fileName, const QByteArray &data)
+{
+    QString path = dir.filePath(fileName);
+
+    QFile f(path);
+    if(!f.open(QIODevice::WriteOnly) || f.write(data) != data.size()){
+        qWarning() << "Error while writing file: " << path;
+    }
+
+    return path;
+}
+
+QTEST_GUILESS_MAIN(ConversionTest)
+
+#include "tst_conversion.moc"
@@ -0,0 +1,17 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = tst_roundtrip
+
+SOURCES += \
+        tst_roundtrip.cpp
+
+# Include test corpora
+include(../shared/shared.pri)
+
+# Include library files
+include(../../qt-xml-json-library/qt-xml-json-library.pri)
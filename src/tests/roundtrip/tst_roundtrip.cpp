@@ -0,0 +1,388 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <QBuffer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "corpus.h"
+#include "xmljsonconverter.h"
+
+using namespace LTDev;
+
+class RoundTripTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void streamingWriter_data();
+    void streamingWriter();
+    void index();
+    void pipelined_data();
+    void pipelined();
+    void pipelinedErrors();
+
+private:
+    /**
+     * @brief Adds a row for each sample and generated corpus
+     */
+    static void addDocuments();
+
+    /**
+     * @brief Returns the json with the attributes sorted by key, since their order isn't preserved by QDomDocument
+     */
+    static QJsonObject normalized(const QJsonObject &jsonObj);
+
+    /**
+     * @brief Returns the path of the first difference between the elements, empty if they are equal
+     */
+    static QString difference(const QDomElement &element, const QDomElement &otherElement, const QString &path);
+
+    /**
+     * @brief Returns the attributes of the element, by name
+     */
+    static QMap<QString, QString> attributes(const QDomElement &element);
+};
+
+
+void RoundTripTest::addDocuments()
+{
+    QTest::addColumn<QByteArray>("xml");
+
+    foreach (const QString &path, Corpus::samples()) {
+        QFile f(path);
+        QVERIFY2(f.open(QIODevice::ReadOnly), qPrintable(path));
+        QTest::newRow(qPrintable(QFileInfo(path).fileName())) << f.readAll();
+    }
+
+    QTest::newRow("records") << Corpus::records(1000);
+    QTest::newRow("nested") << Corpus::nested(8, 3);
+    QTest::newRow("duplicated") << Corpus::duplicated(500);
+}
+
+
+void RoundTripTest::roundTrip_data()
+{
+    addDocuments();
+}
+
+
+/**
+ * XML -> XmlToJson::convert -> JsonToXml::convert -> XML, through the
+ * serialized forms: the documents must have the same elements, and the
+ * second conversion must give the same json of the first one.
+ */
+void RoundTripTest::roundTrip()
+{
+    QFETCH(QByteArray, xml);
+
+    QDomDocument xmlDoc;
+    QVERIFY(xmlDoc.setContent(xml));
+
+    QJsonObject jsonObj = XmlToJson::convert(xmlDoc);
+
+    QJsonParseError error;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(QJsonDocument(jsonObj).toJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QDomDocument convertedXmlDoc;
+    QVERIFY(convertedXmlDoc.setContent(JsonToXml::convert(jsonDoc.object()).toByteArray()));
+
+    QString diff = difference(xmlDoc.documentElement(), convertedXmlDoc.documentElement(), QString());
+    QVERIFY2(diff.isEmpty(), qPrintable("Documents differ at " + diff));
+
+    QCOMPARE(normalized(XmlToJson::convert(convertedXmlDoc)), normalized(jsonObj));
+}
+
+
+void RoundTripTest::streamingWriter_data()
+{
+    addDocuments();
+}
+
+
+/**
+ * The streaming writer must write the same bytes of QJsonDocument, in both formats
+ */
+void RoundTripTest::streamingWriter()
+{
+    QFETCH(QByteArray, xml);
+
+    QDomDocument xmlDoc;
+    QVERIFY(xmlDoc.setContent(xml));
+
+    QJsonObject jsonObj = XmlToJson::convert(xmlDoc);
+
+    foreach (QJsonDocument::JsonFormat format, QList<QJsonDocument::JsonFormat>() << QJsonDocument::Indented << QJsonDocument::Compact) {
+        QByteArray output;
+        QBuffer buffer(&output);
+        buffer.open(QIODevice::WriteOnly);
+
+        QVERIFY(XmlToJson::write(xmlDoc, &buffer, format));
+        QCOMPARE(output, QJsonDocument(jsonObj).toJson(format));
+    }
+}
+
+
+/**
+ * The elements read through the index must be the converted ones
+ */
+void RoundTripTest::index()
+{
+    const int count = 200;
+
+    QDomDocument xmlDoc;
+    QVERIFY(xmlDoc.setContent(Corpus::records(count)));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString jsonPath = dir.filePath("records.json");
+
+    QFile jsonFile(jsonPath);
+    QFile indexFile(JsonIndex::indexPath(jsonPath));
+    QVERIFY(jsonFile.open(QIODevice::WriteOnly));
+    QVERIFY(indexFile.open(QIODevice::WriteOnly));
+    QVERIFY(XmlToJson::write(xmlDoc, &jsonFile, QJsonDocument::Indented, &indexFile));
+    jsonFile.close();
+    indexFile.close();
+
+    JsonIndex index;
+    QVERIFY(index.open(jsonPath));
+
+    QJsonObject root = XmlToJson::convert(xmlDoc).value("root").toObject();
+    QJsonArray records = root.value("elements").toArray();
+
+    QCOMPARE(index.count("/records"), qint64(1));
+    QCOMPARE(index.element("/records", 0), root);
+    QCOMPARE(index.count("/records/record"), qint64(count));
+    QCOMPARE(index.count("/records/record/name"), qint64(count));
+
+    for(int i=0; i<count; i++){
+        QCOMPARE(index.element("/records/record", i), records.at(i).toObject());
+    }
+
+    QVERIFY(index.element("/records/record", count).isEmpty());
+    QVERIFY(index.element("/missing", 0).isEmpty());
+    QVERIFY(index.paths().contains("/records/record/name"));
+    index.close();
+
+    // A truncated index is rejected
+    QVERIFY(indexFile.open(QIODevice::ReadWrite));
+    QVERIFY(indexFile.resize(indexFile.size() - 1));
+    indexFile.close();
+    QVERIFY(!index.open(jsonPath));
+}
+
+
+void RoundTripTest::pipelined_data()
+{
+    addDocuments();
+}
+
+
+/**
+ * The pipelined conversion must give the json of the plain conversion, with
+ * the bytes and the index of the streaming writer
+ */
+void RoundTripTest::pipelined()
+{
+    QFETCH(QByteArray, xml);
+
+    QDomDocument xmlDoc;
+    QVERIFY(xmlDoc.setContent(xml));
+
+    QBuffer input(&xml);
+    input.open(QIODevice::ReadOnly);
+
+    // The json doesn't start at the beginning of the output: the index offsets start from its position
+    QByteArray prefix = "prefix\n";
+
+    QByteArray output, index;
+    QBuffer outputBuffer(&output), indexBuffer(&index);
+    outputBuffer.open(QIODevice::WriteOnly);
+    indexBuffer.open(QIODevice::WriteOnly);
+    outputBuffer.write(prefix);
+
+    ConversionError error;
+    QVERIFY2(PipelinedConverter::convert(&input, &outputBuffer, ConversionOptions(), QJsonDocument::Indented, &indexBuffer, &error),
+             qPrintable(error.message));
+
+    QJsonParseError parseError;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(output.mid(prefix.size()), &parseError);
+    QCOMPARE(parseError.error, QJsonParseError::NoError);
+    QCOMPARE(normalized(jsonDoc.object()), normalized(XmlToJson::convert(xmlDoc)));
+
+    // Same attributes order as the streaming writer: same bytes and same index
+    QByteArray writerIndex;
+    QBuffer writerIndexBuffer(&writerIndex);
+    QBuffer writerOutput;
+    writerIndexBuffer.open(QIODevice::WriteOnly);
+    writerOutput.open(QIODevice::WriteOnly);
+    writerOutput.write(prefix);
+    QVERIFY(XmlToJson::write(xmlDoc, &writerOutput, QJsonDocument::Indented, &writerIndexBuffer));
+
+    QCOMPARE(output, writerOutput.data());
+    QCOMPARE(index, writerIndex);
+}
+
+
+/**
+ * Malformed inputs and exceeded limits must stop the pipeline with an error
+ */
+void RoundTripTest::pipelinedErrors()
+{
+    QByteArray malformed = Corpus::records(2000);
+    malformed.chop(20);
+
+    QBuffer input(&malformed);
+    input.open(QIODevice::ReadOnly);
+    QBuffer output;
+    output.open(QIODevice::WriteOnly);
+
+    ConversionError error;
+    QVERIFY(!PipelinedConverter::convert(&input, &output, ConversionOptions(), QJsonDocument::Indented, nullptr, &error));
+    QCOMPARE(error.code, ConversionError::ParseError);
+
+    QByteArray nested = Corpus::nested(8, 3);
+    QBuffer nestedInput(&nested);
+    nestedInput.open(QIODevice::ReadOnly);
+
+    ConversionOptions options;
+    options.limits.maxDepth = 4;
+
+    QVERIFY(!PipelinedConverter::convert(&nestedInput, &output, options, QJsonDocument::Indented, nullptr, &error));
+    QCOMPARE(error.code, ConversionError::TooDeep);
+
+    // The input size counts bytes, not characters
+    QByteArray multibyte = "<root>" + QString(1000, QChar(0x00E9)).toUtf8() + "</root>";
+    QBuffer multibyteInput(&multibyte);
+    multibyteInput.open(QIODevice::ReadOnly);
+
+    options = ConversionOptions();
+    options.limits.maxInputBytes = multibyte.size() - 1;
+
+    QVERIFY(!PipelinedConverter::convert(&multibyteInput, &output, options, QJsonDocument::Indented, nullptr, &error));
+    QCOMPARE(error.code, ConversionError::InputTooLarge);
+
+    // As on the DOM path
+    QVERIFY(multibyteInput.seek(0));
+    error = ConversionError();
+    QVERIFY(XmlToJson::parse(&multibyteInput, options, &error).isNull());
+    QCOMPARE(error.code, ConversionError::InputTooLarge);
+
+    options.limits.maxInputBytes = multibyte.size();
+
+    QVERIFY(multibyteInput.seek(0));
+    error = ConversionError();
+    QVERIFY(!XmlToJson::parse(&multibyteInput, options, &error).isNull());
+    QCOMPARE(error.code, ConversionError::NoError);
+}
+
+
+QJsonObject RoundTripTest::normalized(const QJsonObject &jsonObj)
+{
+    QJsonObject normalizedObj = jsonObj;
+
+    if(jsonObj.contains("root")){
+        normalizedObj.insert("root", normalized(jsonObj.value("root").toObject()));
+        return normalizedObj;
+    }
+
+    QMap<QString, QJsonValue> sortedAttributes;
+    foreach (const QJsonValue &attr, jsonObj.value("attributes").toArray()) {
+        sortedAttributes.insert(attr.toObject().value("key").toString(), attr);
+    }
+
+    QJsonArray attributesArray;
+    foreach (const QJsonValue &attr, sortedAttributes) {
+        attributesArray.append(attr);
+    }
+
+    QJsonArray elementsArray;
+    foreach (const QJsonValue &element, jsonObj.value("elements").toArray()) {
+        elementsArray.append(normalized(element.toObject()));
+    }
+
+    normalizedObj.insert("attributes", attributesArray);
+    normalizedObj.insert("elements", elementsArray);
+
+    return normalizedObj;
+}
+
+
+QString RoundTripTest::difference(const QDomElement &element, const QDomElement &otherElement, const QString &path)
+{
+    QString elementPath = path + '/' + element.tagName();
+
+    if(element.tagName() != otherElement.tagName()){
+        return elementPath + " (tag " + otherElement.tagName() + ")";
+    }
+
+    if(attributes(element) != attributes(otherElement)){
+        return elementPath + " (attributes)";
+    }
+
+    QDomElement child = element.firstChildElement();
+    QDomElement otherChild = otherElement.firstChildElement();
+
+    // Leaves: the root text is not converted
+    if(child.isNull() && !path.isEmpty() && element.text() != otherElement.text()){
+        return elementPath + " (text)";
+    }
+
+    for(; !child.isNull() && !otherChild.isNull(); child = child.nextSiblingElement(), otherChild = otherChild.nextSiblingElement()){
+        QString diff = difference(child, otherChild, elementPath);
+        if(!diff.isEmpty()){
+            return diff;
+        }
+    }
+
+    if(!child.isNull() || !otherChild.isNull()){
+        return elementPath + " (children)";
+    }
+
+    return QString();
+}
+
+
+QMap<QString, QString> RoundTripTest::attributes(const QDomElement &element)
+{
+    QMap<QString, QString> map;
+    QDomNamedNodeMap attributes = element.attributes();
+
+    for(int i=0; i<attributes.size(); i++){
+        QDomAttr attr = attributes.item(i).toAttr();
+        map.insert(attr.name(), attr.value());
+    }
+
+    return map;
+}
+
+QTEST_GUILESS_MAIN(RoundTripTest)
+
+#include "tst_roundtrip.moc"
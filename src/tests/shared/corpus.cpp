@@ -0,0 +1,209 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "corpus.h"
+
+#include <QDir>
+#include <QXmlStreamWriter>
+
+namespace LTDev {
+
+namespace {
+
+/**
+ * @brief Deterministic pseudo random numbers, so that the corpora are the same on every run
+ */
+class Random
+{
+public:
+    Random(quint32 seed) : m_state(seed) {}
+
+    quint32 next(quint32 bound)
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return (m_state >> 8) % bound;
+    }
+
+private:
+    quint32 m_state;
+};
+
+const char *const words[] = {
+    "quiet", "broad", "journey", "spider", "variety", "writer", "west", "post",
+    "a < b", "c & d", "\"quoted\"", "it's", "caf\xc3\xa9", "\xe2\x82\xac 10", "tab\there", "line\nbreak"
+};
+const int wordCount = sizeof(words) / sizeof(words[0]);
+
+// Attribute values are normalized by the parser: keep tabs and new lines out of them
+const int attributeWordCount = wordCount - 2;
+
+/**
+ * @brief Writes the nested elements of the subtree
+ */
+void writeNested(QXmlStreamWriter &writer, Random &random, int depth, int breadth){
+    for(int i=0; i<breadth; i++){
+        writer.writeStartElement(QString("level%1").arg(depth));
+        writer.writeAttribute("index", QString::number(i));
+
+        if(depth <= 1 || random.next(4) == 0){
+            writer.writeCharacters(QString::fromUtf8(words[random.next(wordCount)]));
+        } else {
+            writeNested(writer, random, depth - 1, breadth);
+        }
+
+        writer.writeEndElement();
+    }
+}
+
+}
+
+/**
+ * Returns the paths of the sample files of XmlJsonConverterSample
+ *
+ * @return QStringList
+ */
+QStringList Corpus::samples()
+{
+    QDir dir(SAMPLES_PATH);
+    QStringList paths;
+
+    foreach (const QString &name, dir.entryList(QDir::Files, QDir::Name)) {
+        paths.append(dir.filePath(name));
+    }
+
+    return paths;
+}
+
+
+/**
+ * Returns a document with a flat list of records, each one with attributes
+ * and leaf children whose texts include characters to escape and non ASCII
+ * characters.
+ *
+ * @param count: the number of records
+ * @param seed: the seed of the generated values
+ *
+ * @return QByteArray
+ */
+QByteArray Corpus::records(int count, quint32 seed)
+{
+    Random random(seed);
+    QByteArray data;
+
+    QXmlStreamWriter writer(&data);
+    writer.setAutoFormatting(true);
+    writer.writeStartDocument();
+    writer.writeStartElement("records");
+
+    for(int i=0; i<count; i++){
+        writer.writeStartElement("record");
+        writer.writeAttribute("id", QString::number(i));
+        writer.writeAttribute("kind", QString::fromUtf8(words[random.next(attributeWordCount)]));
+
+        writer.writeTextElement("name", QString::fromUtf8(words[random.next(wordCount)]));
+        writer.writeTextElement("value", QString::number(random.next(1000000)));
+        writer.writeTextElement("note", QString::fromUtf8(words[random.next(wordCount)]));
+        writer.writeEmptyElement("flag");
+
+        writer.writeEndElement();
+    }
+
+    writer.writeEndElement();
+    writer.writeEndDocument();
+
+    return data;
+}
+
+
+/**
+ * Returns a document with elements nested up to the depth passed. Elements
+ * randomly stop nesting, so the leaves are at different depths.
+ *
+ * @param depth: the maximum depth below the root
+ * @param breadth: the number of children of each nested element
+ * @param seed: the seed of the generated values
+ *
+ * @return QByteArray
+ */
+QByteArray Corpus::nested(int depth, int breadth, quint32 seed)
+{
+    Random random(seed);
+    QByteArray data;
+
+    QXmlStreamWriter writer(&data);
+    writer.setAutoFormatting(true);
+    writer.writeStartDocument();
+    writer.writeStartElement("nested");
+
+    writeNested(writer, random, depth, breadth);
+
+    writer.writeEndElement();
+    writer.writeEndDocument();
+
+    return data;
+}
+
+
+/**
+ * Returns a document repeating a few distinct subtrees, as generated documents
+ * often do
+ *
+ * @param count: the number of subtrees
+ * @param distinct: the number of distinct subtrees
+ *
+ * @return QByteArray
+ */
+QByteArray Corpus::duplicated(int count, int distinct)
+{
+    QByteArray data;
+
+    QXmlStreamWriter writer(&data);
+    writer.setAutoFormatting(true);
+    writer.writeStartDocument();
+    writer.writeStartElement("svg");
+
+    for(int i=0; i<count; i++){
+        int variant = i % distinct;
+
+        writer.writeStartElement("g");
+        writer.writeAttribute("class", QString("shape%1").arg(variant));
+
+        writer.writeStartElement("rect");
+        writer.writeAttribute("width", QString::number(10 * (variant + 1)));
+        writer.writeAttribute("height", "20");
+        writer.writeAttribute("style", "fill:#ff0000;stroke:none");
+        writer.writeEndElement();
+
+        writer.writeTextElement("title", QString("Shape %1").arg(variant));
+
+        writer.writeEndElement();
+    }
+
+    writer.writeEndElement();
+    writer.writeEndDocument();
+
+    return data;
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2020 Leonardo Tarollo <develtar@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <QByteArray>
+#include <QStringList>
+
+
+namespace LTDev {
+
+class Corpus
+{
+public:
+    /**
+     * @brief Returns the paths of the sample files
+     */
+    static QStringList samples();
+
+    /**
+     * @brief Returns a document with a flat list of records, with attributes and texts to escape
+     */
+    static QByteArray records(int count, quint32 seed = 1);
+
+    /**
+     * @brief Returns a document with elements nested up to the depth passed
+     */
+    static QByteArray nested(int depth, int breadth, quint32 seed = 1);
+
+    /**
+     * @brief Returns a document repeating a few distinct subtrees
+     */
+    static QByteArray duplicated(int count, int distinct = 4);
+};
+
+}
+
+#endif // CORPUS_H
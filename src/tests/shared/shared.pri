@@ -0,0 +1,12 @@
+# Test corpora shared by the test cases
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/corpus.cpp
+
+HEADERS += \
+    $$PWD/corpus.h
+
+# Samples directory path
+DEFINES += SAMPLES_PATH=\\\"$$PWD/../../XmlJsonConverterSample/samples\\\"